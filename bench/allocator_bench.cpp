@@ -0,0 +1,114 @@
+#include "arena_allocator.hpp"
+#include "bench.hpp"
+#include "box.hpp"
+#include "pool_allocator.hpp"
+#include "slab_allocator.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace {
+    struct message {
+        long id = 0;
+        char payload[56] = {};
+    };
+
+    template <typename Allocator>
+    void create_destroy(std::size_t iterations) {
+        for (auto i = std::size_t(0); i < iterations; ++i) {
+            auto box = ben::box<message, Allocator>(message{static_cast<long>(i)});
+            bench::do_not_optimize(box);
+        }
+    }
+
+    constexpr auto request_size = std::size_t(1) << 14;
+
+    struct node {
+        long key = 0;
+        long children[6] = {};
+    };
+}
+
+BOX_BENCHMARK(allocator_create_destroy_std) {
+    create_destroy<std::allocator<message>>(iterations);
+}
+
+BOX_BENCHMARK(allocator_create_destroy_pool) {
+    create_destroy<ben::pool_allocator<message>>(iterations);
+}
+
+// One iteration builds and tears down 2^14 boxed nodes, as a request handler would.
+BOX_BENCHMARK(allocator_request_std) {
+    for (auto i = std::size_t(0); i < iterations; ++i) {
+        auto nodes = std::vector<ben::box<node>>();
+        nodes.reserve(request_size);
+
+        for (auto j = std::size_t(0); j < request_size; ++j) {
+            nodes.emplace_back(node{static_cast<long>(j)});
+        }
+
+        bench::do_not_optimize(nodes.data());
+    }
+}
+
+BOX_BENCHMARK(allocator_request_arena) {
+    auto a = ben::arena(request_size * sizeof(node) * 2);
+
+    for (auto i = std::size_t(0); i < iterations; ++i) {
+        {
+            auto nodes = std::vector<ben::box<node, ben::arena_allocator<node>>>();
+            nodes.reserve(request_size);
+
+            for (auto j = std::size_t(0); j < request_size; ++j) {
+                nodes.emplace_back(node{static_cast<long>(j)}, ben::arena_allocator<node>(a));
+            }
+
+            bench::do_not_optimize(nodes.data());
+        }
+
+        a.reset();
+    }
+}
+
+BOX_BENCHMARK(allocator_request_make_boxes) {
+    for (auto i = std::size_t(0); i < iterations; ++i) {
+        auto nodes = ben::make_boxes<node>(request_size, node{static_cast<long>(i)});
+        bench::do_not_optimize(nodes.data());
+    }
+}
+
+// Sums the keys of 2^14 boxed nodes that were allocated one by one, after other allocations were interleaved.
+BOX_BENCHMARK(allocator_scan_individual) {
+    auto nodes = std::vector<ben::box<node>>();
+    auto noise = std::vector<ben::box<node>>();
+
+    for (auto j = std::size_t(0); j < request_size; ++j) {
+        nodes.emplace_back(node{static_cast<long>(j)});
+        noise.emplace_back(node{});
+    }
+
+    for (auto i = std::size_t(0); i < iterations; ++i) {
+        auto sum = long(0);
+
+        for (auto const& n : nodes) {
+            sum += n.value().key;
+        }
+
+        bench::do_not_optimize(sum);
+    }
+}
+
+BOX_BENCHMARK(allocator_scan_make_boxes) {
+    auto nodes = ben::make_boxes<node>(request_size, node{1});
+
+    for (auto i = std::size_t(0); i < iterations; ++i) {
+        auto sum = long(0);
+
+        for (auto const& n : nodes) {
+            sum += n.value().key;
+        }
+
+        bench::do_not_optimize(sum);
+    }
+}
@@ -0,0 +1,68 @@
+#ifndef BEN_BENCH_HPP
+#define BEN_BENCH_HPP
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace bench {
+    using benchmark_fn = void (*)(std::size_t iterations);
+    using measurement_fn = auto (*)() -> double;
+
+    // Either a timed benchmark, a measurement that produces its own value such as a latency percentile, or a
+    // constant such as the size of a type when both `fn` and `measure` are null.
+    struct benchmark {
+        std::string name;
+        benchmark_fn fn;
+        double value;
+        char const* unit;
+        measurement_fn measure = nullptr;
+    };
+
+    inline auto registry() -> std::vector<benchmark>& {
+        static auto benchmarks = std::vector<benchmark>();
+        return benchmarks;
+    }
+
+    struct registration {
+        registration(char const* name, benchmark_fn fn) {
+            registry().push_back({name, fn, 0.0, "ns/op"});
+        }
+
+        registration(char const* name, double value, char const* unit) {
+            registry().push_back({name, nullptr, value, unit});
+        }
+
+        registration(char const* name, measurement_fn measure, char const* unit) {
+            registry().push_back({name, nullptr, 0.0, unit, measure});
+        }
+    };
+
+    // Keeps the optimizer from discarding `value` or the computations leading up to it.
+    template <typename T>
+    void do_not_optimize(T const& value) {
+        asm volatile("" : : "r,m"(value) : "memory");
+    }
+
+    // Forces all pending writes to memory to be considered observable.
+    inline void clobber() {
+        asm volatile("" : : : "memory");
+    }
+}
+
+#define BOX_BENCHMARK(name)                                                           \
+    static void name(std::size_t iterations);                                         \
+    static bench::registration name##_registration(#name, name);                      \
+    static void name(std::size_t iterations)
+
+// Reports a value that is not a timing, e.g. the size of a type.
+#define BOX_REPORT(name, value, unit)                                                 \
+    static bench::registration name##_registration(#name, static_cast<double>(value), unit)
+
+// Reports a value that the benchmark measures itself, e.g. a percentile of many individually timed operations.
+#define BOX_MEASUREMENT(name, unit)                                                   \
+    static auto name() -> double;                                                     \
+    static bench::registration name##_registration(#name, name, unit);                \
+    static auto name() -> double
+
+#endif // BEN_BENCH_HPP
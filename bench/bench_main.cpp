@@ -0,0 +1,121 @@
+#include "bench.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+    struct result {
+        std::string const* name;
+        std::size_t iterations;
+        double value;
+        char const* unit;
+    };
+
+    enum class format { text, csv, json };
+
+    struct options {
+        std::string_view filter;
+        format output = format::text;
+        std::chrono::milliseconds min_time = std::chrono::milliseconds(200);
+    };
+
+    // Doubles the iteration count until a run takes long enough to yield a meaningful per-iteration time.
+    auto run(bench::benchmark const& b, options const& opts) -> result {
+        using clock = std::chrono::steady_clock;
+
+        if (b.measure != nullptr) {
+            return {&b.name, 0, b.measure(), b.unit};
+        }
+
+        if (b.fn == nullptr) {
+            return {&b.name, 0, b.value, b.unit};
+        }
+
+        for (auto iterations = std::size_t(1);; iterations *= 2) {
+            auto start = clock::now();
+            b.fn(iterations);
+            auto elapsed = clock::now() - start;
+
+            if (elapsed >= opts.min_time) {
+                auto ns = std::chrono::duration<double, std::nano>(elapsed).count();
+                return {&b.name, iterations, ns / iterations, b.unit};
+            }
+        }
+    }
+
+    void print_header(format output) {
+        if (output == format::csv) {
+            std::printf("name,iterations,value,unit\n");
+        } else if (output == format::json) {
+            std::printf("{\n  \"benchmarks\": [");
+        }
+    }
+
+    void print(result const& r, format output, bool first) {
+        switch (output) {
+            case format::text:
+                std::printf("%-48s %16.2f %s\n", r.name->c_str(), r.value, r.unit);
+                break;
+            case format::csv:
+                std::printf("%s,%zu,%.4f,%s\n", r.name->c_str(), r.iterations, r.value, r.unit);
+                break;
+            case format::json:
+                std::printf("%s\n    {\"name\": \"%s\", \"iterations\": %zu, \"value\": %.4f, \"unit\": \"%s\"}",
+                    first ? "" : ",", r.name->c_str(), r.iterations, r.value, r.unit);
+                break;
+        }
+
+        std::fflush(stdout);
+    }
+
+    void print_footer(format output) {
+        if (output == format::json) {
+            std::printf("\n  ]\n}\n");
+        }
+    }
+
+    auto parse(int argc, char** argv) -> options {
+        auto opts = options();
+
+        for (auto i = 1; i < argc; ++i) {
+            auto arg = std::string_view(argv[i]);
+
+            if (arg == "--csv") {
+                opts.output = format::csv;
+            } else if (arg == "--json") {
+                opts.output = format::json;
+            } else if (arg.substr(0, 11) == "--min-time=") {
+                opts.min_time = std::chrono::milliseconds(std::atol(argv[i] + 11));
+            } else {
+                opts.filter = arg;
+            }
+        }
+
+        return opts;
+    }
+}
+
+// Usage: box_bench [--csv | --json] [--min-time=<milliseconds>] [filter]
+// Only benchmarks whose name contains `filter` are run. Results go to stdout, one benchmark per line (text and
+// CSV) or as a single JSON document, so that they can be stored and compared over time.
+int main(int argc, char** argv) {
+    auto opts = parse(argc, argv);
+    auto first = true;
+
+    print_header(opts.output);
+
+    for (auto const& b : bench::registry()) {
+        if (b.name.find(opts.filter) == std::string::npos) {
+            continue;
+        }
+
+        print(run(b, opts), opts.output, first);
+        first = false;
+    }
+
+    print_footer(opts.output);
+}
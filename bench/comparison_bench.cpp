@@ -0,0 +1,250 @@
+#include "arena_allocator.hpp"
+#include "bench.hpp"
+#include "box.hpp"
+#include "pool_allocator.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Compares the hot paths of box against the other ways of holding at most one object: std::unique_ptr,
+// std::optional and a std::vector with a single element.
+namespace {
+    struct payload {
+        long id = 0;
+        long data[7] = {};
+    };
+
+    namespace holder {
+        using box = ben::box<payload>;
+        using unique_ptr = std::unique_ptr<payload>;
+        using optional = std::optional<payload>;
+        using vector = std::vector<payload>;
+    }
+
+    // The natural way of performing each operation with each holder.
+    template <typename Holder>
+    auto make(long id) -> Holder {
+        if constexpr (std::is_same_v<Holder, holder::unique_ptr>) {
+            return std::make_unique<payload>(payload{id});
+        } else if constexpr (std::is_same_v<Holder, holder::vector>) {
+            return holder::vector{payload{id}};
+        } else {
+            return Holder(payload{id});
+        }
+    }
+
+    template <typename Holder>
+    auto deep_copy(Holder const& h) -> Holder {
+        if constexpr (std::is_same_v<Holder, holder::unique_ptr>) {
+            return std::make_unique<payload>(*h);
+        } else {
+            return h;
+        }
+    }
+
+    template <typename Holder>
+    auto get(Holder const& h) -> payload const& {
+        if constexpr (std::is_same_v<Holder, holder::vector>) {
+            return h.front();
+        } else {
+            return *h;
+        }
+    }
+
+    template <typename Holder>
+    void replace(Holder& h, long id) {
+        if constexpr (std::is_same_v<Holder, holder::unique_ptr>) {
+            h = std::make_unique<payload>(payload{id});
+        } else if constexpr (std::is_same_v<Holder, holder::vector>) {
+            h.clear();
+            h.push_back(payload{id});
+        } else {
+            h.emplace(payload{id});
+        }
+    }
+
+    template <typename Holder>
+    void erase_push(Holder& h, long id) {
+        if constexpr (std::is_same_v<Holder, holder::box>) {
+            h.erase();
+            h.push(payload{id});
+        } else if constexpr (std::is_same_v<Holder, holder::unique_ptr>) {
+            h.reset();
+            h = std::make_unique<payload>(payload{id});
+        } else if constexpr (std::is_same_v<Holder, holder::optional>) {
+            h.reset();
+            h.emplace(payload{id});
+        } else {
+            h.clear();
+            h.push_back(payload{id});
+        }
+    }
+
+    template <typename Holder>
+    void construct(std::size_t iterations) {
+        for (auto i = std::size_t(0); i < iterations; ++i) {
+            auto h = make<Holder>(static_cast<long>(i));
+            bench::do_not_optimize(h);
+        }
+    }
+
+    template <typename Holder>
+    void copy(std::size_t iterations) {
+        auto const h = make<Holder>(1);
+
+        for (auto i = std::size_t(0); i < iterations; ++i) {
+            auto c = deep_copy(h);
+            bench::do_not_optimize(c);
+        }
+    }
+
+    template <typename Holder>
+    void move(std::size_t iterations) {
+        auto h = make<Holder>(1);
+
+        for (auto i = std::size_t(0); i < iterations; ++i) {
+            auto moved = std::move(h);
+            bench::do_not_optimize(moved);
+            h = std::move(moved);
+        }
+    }
+
+    // Two move assignments per iteration.
+    template <typename Holder>
+    void move_assign(Holder a, Holder b, std::size_t iterations) {
+        for (auto i = std::size_t(0); i < iterations; ++i) {
+            b = std::move(a);
+            a = std::move(b);
+            bench::do_not_optimize(a);
+        }
+    }
+
+    template <typename Holder>
+    void emplace(std::size_t iterations) {
+        auto h = make<Holder>(1);
+
+        for (auto i = std::size_t(0); i < iterations; ++i) {
+            replace(h, static_cast<long>(i));
+            bench::do_not_optimize(h);
+        }
+    }
+
+    template <typename Holder>
+    void reuse(std::size_t iterations) {
+        auto h = make<Holder>(1);
+
+        for (auto i = std::size_t(0); i < iterations; ++i) {
+            erase_push(h, static_cast<long>(i));
+            bench::do_not_optimize(h);
+        }
+    }
+
+    constexpr auto scan_size = std::size_t(1) << 16;
+
+    // One iteration sums up the ids of 2^16 holders.
+    template <typename Holder>
+    void scan(std::size_t iterations) {
+        auto holders = std::vector<Holder>();
+        holders.reserve(scan_size);
+
+        for (auto i = std::size_t(0); i < scan_size; ++i) {
+            holders.push_back(make<Holder>(static_cast<long>(i)));
+        }
+
+        for (auto i = std::size_t(0); i < iterations; ++i) {
+            auto sum = 0L;
+
+            for (auto const& h : holders) {
+                sum += get(h).id;
+            }
+
+            bench::do_not_optimize(sum);
+        }
+    }
+}
+
+#define BOX_COMPARISON(operation, holder_name)                                        \
+    BOX_BENCHMARK(compare_##operation##_##holder_name) {                              \
+        operation<holder::holder_name>(iterations);                                   \
+    }
+
+BOX_REPORT(compare_size_box, sizeof(holder::box), "bytes");
+BOX_REPORT(compare_size_unique_ptr, sizeof(holder::unique_ptr), "bytes");
+BOX_REPORT(compare_size_optional, sizeof(holder::optional), "bytes");
+BOX_REPORT(compare_size_vector, sizeof(holder::vector), "bytes");
+
+BOX_COMPARISON(construct, box)
+BOX_COMPARISON(construct, unique_ptr)
+BOX_COMPARISON(construct, optional)
+BOX_COMPARISON(construct, vector)
+
+BOX_COMPARISON(copy, box)
+BOX_COMPARISON(copy, unique_ptr)
+BOX_COMPARISON(copy, optional)
+BOX_COMPARISON(copy, vector)
+
+BOX_COMPARISON(move, box)
+BOX_COMPARISON(move, unique_ptr)
+BOX_COMPARISON(move, optional)
+BOX_COMPARISON(move, vector)
+
+BOX_COMPARISON(emplace, box)
+BOX_COMPARISON(emplace, unique_ptr)
+BOX_COMPARISON(emplace, optional)
+BOX_COMPARISON(emplace, vector)
+
+BOX_COMPARISON(reuse, box)
+BOX_COMPARISON(reuse, unique_ptr)
+BOX_COMPARISON(reuse, optional)
+BOX_COMPARISON(reuse, vector)
+
+BOX_COMPARISON(scan, box)
+BOX_COMPARISON(scan, unique_ptr)
+BOX_COMPARISON(scan, optional)
+BOX_COMPARISON(scan, vector)
+
+BOX_BENCHMARK(compare_move_assign_box) {
+    move_assign(make<holder::box>(1), make<holder::box>(2), iterations);
+}
+
+BOX_BENCHMARK(compare_move_assign_box_pool) {
+    using pool_box = ben::box<payload, ben::pool_allocator<payload>>;
+    move_assign(pool_box(payload{1}), pool_box(payload{2}), iterations);
+}
+
+BOX_BENCHMARK(compare_move_assign_box_arena) {
+    using arena_box = ben::box<payload, ben::arena_allocator<payload>>;
+
+    auto a = ben::arena();
+    auto b = ben::arena();
+    move_assign(arena_box(payload{1}, a), arena_box(payload{2}, b), iterations);
+}
+
+BOX_BENCHMARK(compare_move_assign_box_pmr_same_resource) {
+    auto resource = std::pmr::unsynchronized_pool_resource();
+    move_assign(ben::pmr::box<payload>(payload{1}, &resource), ben::pmr::box<payload>(payload{2}, &resource),
+                iterations);
+}
+
+BOX_BENCHMARK(compare_move_assign_box_pmr_other_resource) {
+    auto a = std::pmr::unsynchronized_pool_resource();
+    auto b = std::pmr::unsynchronized_pool_resource();
+    move_assign(ben::pmr::box<payload>(payload{1}, &a), ben::pmr::box<payload>(payload{2}, &b), iterations);
+}
+
+BOX_BENCHMARK(compare_move_assign_unique_ptr) {
+    move_assign(make<holder::unique_ptr>(1), make<holder::unique_ptr>(2), iterations);
+}
+
+BOX_BENCHMARK(compare_move_assign_optional) {
+    move_assign(make<holder::optional>(1), make<holder::optional>(2), iterations);
+}
+
+BOX_BENCHMARK(compare_move_assign_vector) {
+    move_assign(make<holder::vector>(1), make<holder::vector>(2), iterations);
+}
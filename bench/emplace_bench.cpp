@@ -0,0 +1,73 @@
+#include "bench.hpp"
+#include "box.hpp"
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace {
+    // A large aggregate whose construction dominates the cost of emplacing it.
+    struct large {
+        std::string name;
+        std::array<long, 128> data;
+
+        explicit large(long seed) : name(40, static_cast<char>('a' + seed % 26)) {
+            data.fill(seed);
+        }
+    };
+
+    template <typename Strategy>
+    struct emplace_policy : ben::default_box_policy {
+        using emplace_strategy = Strategy;
+    };
+
+    template <typename T, typename Strategy>
+    using strategy_box = ben::box<T, std::allocator<T>, emplace_policy<Strategy>>;
+
+    template <typename Strategy>
+    void emplace_large(std::size_t iterations) {
+        auto box = strategy_box<large, Strategy>(large(0));
+
+        for (auto i = std::size_t(0); i < iterations; ++i) {
+            box.emplace(static_cast<long>(i));
+            bench::do_not_optimize(box.value());
+        }
+    }
+
+    template <typename Strategy>
+    void push_string(std::size_t iterations) {
+        auto const value = std::string(100, 'x');
+        auto box = strategy_box<std::string, Strategy>(value);
+
+        for (auto i = std::size_t(0); i < iterations; ++i) {
+            box.push(value);
+            bench::do_not_optimize(box.value());
+        }
+    }
+}
+
+// assign_emplace is what emplace always did before strategies were introduced.
+BOX_BENCHMARK(emplace_large_assign) {
+    emplace_large<ben::assign_emplace>(iterations);
+}
+
+BOX_BENCHMARK(emplace_large_reconstruct) {
+    emplace_large<ben::reconstruct_emplace>(iterations);
+}
+
+BOX_BENCHMARK(emplace_large_adaptive) {
+    emplace_large<ben::adaptive_emplace>(iterations);
+}
+
+BOX_BENCHMARK(emplace_push_string_assign) {
+    push_string<ben::assign_emplace>(iterations);
+}
+
+BOX_BENCHMARK(emplace_push_string_reconstruct) {
+    push_string<ben::reconstruct_emplace>(iterations);
+}
+
+BOX_BENCHMARK(emplace_push_string_adaptive) {
+    push_string<ben::adaptive_emplace>(iterations);
+}
@@ -0,0 +1,118 @@
+#include "bench.hpp"
+#include "box.hpp"
+#include "indirect_view.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <random>
+#include <vector>
+
+// Scans boxes whose elements are scattered across the heap, as they are after a collection has been shuffled or
+// churned for a while, with and without prefetching.
+namespace {
+    struct record {
+        long key;
+        long payload[7];
+    };
+
+    using records = std::vector<ben::box<record>>;
+
+    auto make_records(std::size_t count) -> records {
+        auto boxes = records();
+        boxes.reserve(count);
+
+        for (auto i = std::size_t(0); i < count; ++i) {
+            boxes.emplace_back(record{static_cast<long>(i), {}});
+        }
+
+        std::shuffle(boxes.begin(), boxes.end(), std::mt19937_64(42));
+        return boxes;
+    }
+
+    // Only the data set being measured is kept, since the larger ones take gigabytes. Asking for another size, or
+    // calling `release_records`, frees it.
+    auto cached_records() -> records& {
+        static auto boxes = records();
+        return boxes;
+    }
+
+    auto records_of(std::size_t count) -> records& {
+        auto& boxes = cached_records();
+
+        if (boxes.size() != count) {
+            records().swap(boxes);
+            boxes = make_records(count);
+        }
+
+        return boxes;
+    }
+
+    void release_records() {
+        records().swap(cached_records());
+    }
+
+    // Returns the time per element. The first scan only warms up, so that neither building the boxes nor faulting
+    // in their memory is measured.
+    template <std::size_t Count, std::size_t Distance>
+    auto scan() -> double {
+        using clock = std::chrono::steady_clock;
+
+        auto& boxes = records_of(Count);
+        auto scans = std::size_t(0);
+        auto elapsed = clock::duration();
+
+        for (auto start = clock::now(); scans < 2 || elapsed < std::chrono::milliseconds(200); ++scans) {
+            auto sum = long(0);
+
+            for (auto const& r : ben::indirect(boxes, Distance)) {
+                sum += r.key;
+            }
+
+            bench::do_not_optimize(sum);
+
+            if (scans == 0) {
+                start = clock::now();
+            } else {
+                elapsed = clock::now() - start;
+            }
+        }
+
+        auto ns = std::chrono::duration<double, std::nano>(elapsed).count();
+        return ns / static_cast<double>((scans - 1) * Count);
+    }
+
+    // There is no 100M case: its boxes alone would take about 9 GB, 64 bytes per element plus allocator overhead
+    // and the pointer, which is more than the machines running these benchmarks can spare. 10M already exceeds every
+    // cache by far, so larger sizes would not change the picture; raise `large` to measure them anyway.
+    constexpr auto small = std::size_t(1'000'000);
+    constexpr auto large = std::size_t(10'000'000);
+}
+
+BOX_MEASUREMENT(indirect_scan_1m_no_prefetch, "ns/element") {
+    return scan<small, 0>();
+}
+
+BOX_MEASUREMENT(indirect_scan_1m_prefetch_8, "ns/element") {
+    return scan<small, 8>();
+}
+
+BOX_MEASUREMENT(indirect_scan_1m_prefetch_16, "ns/element") {
+    auto result = scan<small, 16>();
+    release_records();
+    return result;
+}
+
+BOX_MEASUREMENT(indirect_scan_10m_no_prefetch, "ns/element") {
+    return scan<large, 0>();
+}
+
+BOX_MEASUREMENT(indirect_scan_10m_prefetch_8, "ns/element") {
+    return scan<large, 8>();
+}
+
+BOX_MEASUREMENT(indirect_scan_10m_prefetch_16, "ns/element") {
+    auto result = scan<large, 16>();
+    release_records();
+    return result;
+}
@@ -0,0 +1,85 @@
+#include "bench.hpp"
+#include "box.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace {
+    struct flag_policy : ben::default_box_policy {
+        using layout = ben::flag_layout;
+    };
+
+    struct tagged_policy : ben::default_box_policy {
+        using layout = ben::tagged_layout;
+    };
+
+    template <typename Policy>
+    using int_box = ben::box<int, std::allocator<int>, Policy>;
+
+    constexpr auto scan_size = std::size_t(1) << 20;
+
+    // Every fourth box is erased, so the scan has to look at the flag of each element.
+    template <typename Policy>
+    auto make_boxes() -> std::vector<int_box<Policy>> {
+        auto boxes = std::vector<int_box<Policy>>(scan_size);
+
+        for (auto i = std::size_t(0); i < scan_size; ++i) {
+            boxes[i].push(static_cast<int>(i));
+
+            if (i % 4 == 0) {
+                boxes[i].erase();
+            }
+        }
+
+        return boxes;
+    }
+
+    template <typename Policy>
+    void scan(std::size_t iterations) {
+        static auto const boxes = make_boxes<Policy>();
+
+        for (auto i = std::size_t(0); i < iterations; ++i) {
+            auto sum = 0L;
+
+            for (auto const& box : boxes) {
+                if (box.has_value()) {
+                    sum += box.value();
+                }
+            }
+
+            bench::do_not_optimize(sum);
+        }
+    }
+
+    template <typename Policy>
+    void push_erase(std::size_t iterations) {
+        auto box = int_box<Policy>(0);
+
+        for (auto i = std::size_t(0); i < iterations; ++i) {
+            box.erase();
+            box.push(static_cast<int>(i));
+            bench::do_not_optimize(box);
+        }
+    }
+}
+
+BOX_REPORT(layout_size_flag, sizeof(int_box<flag_policy>), "bytes");
+BOX_REPORT(layout_size_tagged, sizeof(int_box<tagged_policy>), "bytes");
+
+// One scan iteration visits 2^20 boxes.
+BOX_BENCHMARK(layout_scan_flag) {
+    scan<flag_policy>(iterations);
+}
+
+BOX_BENCHMARK(layout_scan_tagged) {
+    scan<tagged_policy>(iterations);
+}
+
+BOX_BENCHMARK(layout_push_erase_flag) {
+    push_erase<flag_policy>(iterations);
+}
+
+BOX_BENCHMARK(layout_push_erase_tagged) {
+    push_erase<tagged_policy>(iterations);
+}
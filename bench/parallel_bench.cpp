@@ -0,0 +1,73 @@
+#include "bench.hpp"
+#include "box.hpp"
+#include "parallel.hpp"
+#include "pool_allocator.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+// Copies and then destroys a large collection of boxes, one element at a time on a single thread or split across
+// all cores. One iteration is one copy followed by one destruction of the copy.
+namespace {
+    struct message {
+        long id = 0;
+        char payload[56] = {};
+    };
+
+    constexpr auto collection_size = std::size_t(2'000'000);
+
+    template <typename Allocator>
+    auto source() -> std::vector<ben::box<message, Allocator>> const& {
+        static auto const boxes = [] {
+            auto result = std::vector<ben::box<message, Allocator>>();
+            result.reserve(collection_size);
+
+            for (auto i = std::size_t(0); i < collection_size; ++i) {
+                result.emplace_back(message{static_cast<long>(i)});
+            }
+
+            return result;
+        }();
+
+        return boxes;
+    }
+
+    template <typename Allocator>
+    void sequential(std::size_t iterations) {
+        auto const& boxes = source<Allocator>();
+
+        for (auto i = std::size_t(0); i < iterations; ++i) {
+            auto copy = boxes;
+            bench::do_not_optimize(copy.data());
+        }
+    }
+
+    template <typename Allocator>
+    void parallel(std::size_t iterations) {
+        auto const& boxes = source<Allocator>();
+
+        for (auto i = std::size_t(0); i < iterations; ++i) {
+            auto copy = std::vector<ben::box<message, Allocator>>(boxes.size());
+            ben::parallel_clone(boxes, copy.begin());
+            bench::do_not_optimize(copy.data());
+            ben::parallel_destroy(copy);
+        }
+    }
+}
+
+BOX_BENCHMARK(parallel_clone_destroy_sequential_std) {
+    sequential<std::allocator<message>>(iterations);
+}
+
+BOX_BENCHMARK(parallel_clone_destroy_parallel_std) {
+    parallel<std::allocator<message>>(iterations);
+}
+
+BOX_BENCHMARK(parallel_clone_destroy_sequential_pool) {
+    sequential<ben::pool_allocator<message>>(iterations);
+}
+
+BOX_BENCHMARK(parallel_clone_destroy_parallel_pool) {
+    parallel<ben::pool_allocator<message>>(iterations);
+}
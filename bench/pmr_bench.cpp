@@ -0,0 +1,71 @@
+#include "bench.hpp"
+#include "box.hpp"
+
+#include <cstddef>
+#include <memory_resource>
+#include <utility>
+#include <vector>
+
+namespace {
+    struct message {
+        long id = 0;
+        char payload[56] = {};
+    };
+
+    constexpr auto batch_size = std::size_t(1) << 12;
+
+    // One iteration creates and destroys a batch of boxes from `resource`.
+    void create_destroy(std::pmr::memory_resource* resource, std::size_t iterations) {
+        for (auto i = std::size_t(0); i < iterations; ++i) {
+            auto boxes = std::vector<ben::pmr::box<message>>();
+            boxes.reserve(batch_size);
+
+            for (auto j = std::size_t(0); j < batch_size; ++j) {
+                boxes.emplace_back(message{static_cast<long>(j)}, resource);
+            }
+
+            bench::do_not_optimize(boxes.data());
+        }
+    }
+
+    void move_assign(std::pmr::memory_resource* from, std::pmr::memory_resource* to, std::size_t iterations) {
+        auto source = ben::pmr::box<message>(message(), from);
+        auto target = ben::pmr::box<message>(message(), to);
+
+        for (auto i = std::size_t(0); i < iterations; ++i) {
+            target = std::move(source);
+            source = std::move(target);
+            bench::do_not_optimize(source);
+        }
+    }
+}
+
+BOX_BENCHMARK(pmr_create_destroy_new_delete) {
+    create_destroy(std::pmr::new_delete_resource(), iterations);
+}
+
+BOX_BENCHMARK(pmr_create_destroy_monotonic) {
+    auto resource = std::pmr::monotonic_buffer_resource();
+
+    for (auto i = std::size_t(0); i < iterations; ++i) {
+        create_destroy(&resource, 1);
+        resource.release();
+    }
+}
+
+BOX_BENCHMARK(pmr_create_destroy_unsynchronized_pool) {
+    auto resource = std::pmr::unsynchronized_pool_resource();
+    create_destroy(&resource, iterations);
+}
+
+// Two move assignments per iteration.
+BOX_BENCHMARK(pmr_move_assign_same_resource) {
+    auto resource = std::pmr::unsynchronized_pool_resource();
+    move_assign(&resource, &resource, iterations);
+}
+
+BOX_BENCHMARK(pmr_move_assign_other_resource) {
+    auto a = std::pmr::unsynchronized_pool_resource();
+    auto b = std::pmr::unsynchronized_pool_resource();
+    move_assign(&a, &b, iterations);
+}
@@ -0,0 +1,76 @@
+#include "bench.hpp"
+#include "box.hpp"
+#include "epoch.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Measures how long a latency-critical thread is stalled by dropping a large boxed object: destroying it right
+// away, or retiring it into an epoch domain that a background thread collects.
+namespace {
+    using clock = std::chrono::steady_clock;
+    using table = std::vector<std::string>;
+
+    constexpr auto samples = std::size_t(2000);
+    constexpr auto table_size = std::size_t(1000);
+
+    auto make_table() -> ben::box<table> {
+        return ben::box<table>(table(table_size, std::string(64, 'x')));
+    }
+
+    auto percentile(std::vector<double> latencies, double p) -> double {
+        std::sort(latencies.begin(), latencies.end());
+        return latencies[static_cast<std::size_t>(p * static_cast<double>(latencies.size() - 1))];
+    }
+
+    // Only the drop itself is timed, building the next table is not.
+    template <typename Drop>
+    auto drop_latencies(Drop drop) -> std::vector<double> {
+        auto latencies = std::vector<double>();
+        latencies.reserve(samples);
+
+        for (auto i = std::size_t(0); i < samples; ++i) {
+            auto b = make_table();
+            bench::do_not_optimize(b);
+
+            auto start = clock::now();
+            drop(b);
+            auto elapsed = clock::now() - start;
+
+            latencies.push_back(std::chrono::duration<double, std::nano>(elapsed).count());
+        }
+
+        return latencies;
+    }
+
+    auto immediate_latencies() -> std::vector<double> {
+        return drop_latencies([](ben::box<table>& b) { b.reset(); });
+    }
+
+    auto deferred_latencies() -> std::vector<double> {
+        auto domain = ben::epoch_domain(0);
+        auto reclaimer = ben::background_reclaimer(domain);
+
+        return drop_latencies([&](ben::box<table>& b) { domain.retire(std::move(b)); });
+    }
+}
+
+BOX_MEASUREMENT(reclaim_drop_p50_immediate, "ns") {
+    return percentile(immediate_latencies(), 0.5);
+}
+
+BOX_MEASUREMENT(reclaim_drop_p99_immediate, "ns") {
+    return percentile(immediate_latencies(), 0.99);
+}
+
+BOX_MEASUREMENT(reclaim_drop_p50_deferred, "ns") {
+    return percentile(deferred_latencies(), 0.5);
+}
+
+BOX_MEASUREMENT(reclaim_drop_p99_deferred, "ns") {
+    return percentile(deferred_latencies(), 0.99);
+}
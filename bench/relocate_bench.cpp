@@ -0,0 +1,88 @@
+#include "bench.hpp"
+#include "box.hpp"
+#include "relocate.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <vector>
+
+namespace {
+    using int_box = ben::box<int>;
+
+    constexpr auto growth_size = std::size_t(10'000'000);
+
+    // Moves each element over and destroys the old one, as std::vector does.
+    struct move_elements {
+        static auto grow(std::allocator<int_box>& alloc, int_box* data, std::size_t size, std::size_t capacity,
+                         std::size_t new_capacity) -> int_box* {
+            auto new_data = alloc.allocate(new_capacity);
+            std::uninitialized_move(data, data + size, new_data);
+            std::destroy(data, data + size);
+
+            if (data != nullptr) {
+                alloc.deallocate(data, capacity);
+            }
+
+            return new_data;
+        }
+    };
+
+    struct relocate_elements {
+        static auto grow(std::allocator<int_box>& alloc, int_box* data, std::size_t size, std::size_t capacity,
+                         std::size_t new_capacity) -> int_box* {
+            return ben::relocate_grow(alloc, data, size, capacity, new_capacity);
+        }
+    };
+
+    // Appends boxes one by one, doubling the capacity whenever it runs out. The boxes are empty, since relocating
+    // a box never touches its element anyway and allocating the elements would dominate the measurement.
+    template <typename Growth>
+    void grow(std::size_t iterations) {
+        for (auto i = std::size_t(0); i < iterations; ++i) {
+            auto alloc = std::allocator<int_box>();
+            int_box* data = nullptr;
+            auto size = std::size_t(0);
+            auto capacity = std::size_t(0);
+
+            while (size < growth_size) {
+                if (size == capacity) {
+                    auto new_capacity = capacity == 0 ? std::size_t(1) : capacity * 2;
+                    data = Growth::grow(alloc, data, size, capacity, new_capacity);
+                    capacity = new_capacity;
+                }
+
+                new (data + size) int_box();
+                ++size;
+            }
+
+            bench::do_not_optimize(data);
+
+            std::destroy(data, data + size);
+            alloc.deallocate(data, capacity);
+        }
+    }
+}
+
+BOX_REPORT(relocate_is_trivially_relocatable_box, ben::is_trivially_relocatable_v<int_box>, "bool");
+
+// One iteration grows a buffer to 10M boxes.
+BOX_BENCHMARK(relocate_growth_vector) {
+    for (auto i = std::size_t(0); i < iterations; ++i) {
+        auto boxes = std::vector<int_box>();
+
+        for (auto j = std::size_t(0); j < growth_size; ++j) {
+            boxes.emplace_back();
+        }
+
+        bench::do_not_optimize(boxes.data());
+    }
+}
+
+BOX_BENCHMARK(relocate_growth_move) {
+    grow<move_elements>(iterations);
+}
+
+BOX_BENCHMARK(relocate_growth_relocate) {
+    grow<relocate_elements>(iterations);
+}
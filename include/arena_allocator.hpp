@@ -0,0 +1,169 @@
+#ifndef BEN_ARENA_ALLOCATOR_HPP
+#define BEN_ARENA_ALLOCATOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+
+namespace ben {
+
+    // A monotonic memory resource: memory is handed out from large chunks by bumping a pointer and is only given
+    // back all at once, either by `reset()`, which keeps the chunks around for reuse, or by `release()`.
+    class arena {
+        private:
+        struct chunk {
+            chunk* next;
+            std::size_t size;
+        };
+
+        static constexpr std::size_t m_default_chunk_size = 4096;
+
+        chunk* m_first = nullptr;
+        chunk* m_current = nullptr;
+        unsigned char* m_bump = nullptr;
+        unsigned char* m_end = nullptr;
+        std::size_t m_next_chunk_size;
+
+        static auto data_of(chunk* c) noexcept -> unsigned char* {
+            return reinterpret_cast<unsigned char*>(c + 1);
+        }
+
+        static auto align_up(unsigned char* ptr, std::size_t alignment) noexcept -> unsigned char* {
+            auto address = reinterpret_cast<std::uintptr_t>(ptr);
+            return ptr + ((alignment - address % alignment) % alignment);
+        }
+
+        void enter(chunk* c) noexcept {
+            m_current = c;
+            m_bump = data_of(c);
+            m_end = m_bump + c->size;
+        }
+
+        // Moves on to the next chunk that is large enough, allocating a new one if there is none.
+        void advance(std::size_t bytes, std::size_t alignment) {
+            auto required = bytes + alignment;
+
+            while (m_current != nullptr && m_current->next != nullptr) {
+                enter(m_current->next);
+
+                if (m_current->size >= required) {
+                    return;
+                }
+            }
+
+            auto size = m_next_chunk_size > required ? m_next_chunk_size : required;
+            auto c = new (::operator new(sizeof(chunk) + size)) chunk{nullptr, size};
+            m_next_chunk_size = size * 2;
+
+            if (m_current == nullptr) {
+                m_first = c;
+            } else {
+                m_current->next = c;
+            }
+
+            enter(c);
+        }
+
+        public:
+        explicit arena(std::size_t initial_chunk_size = m_default_chunk_size) noexcept
+            : m_next_chunk_size(initial_chunk_size) {}
+
+        arena(arena const&) = delete;
+        auto operator=(arena const&) -> arena& = delete;
+
+        ~arena() {
+            release();
+        }
+
+        auto allocate(std::size_t bytes, std::size_t alignment) -> void* {
+            auto ptr = m_bump != nullptr ? align_up(m_bump, alignment) : nullptr;
+
+            if (ptr == nullptr || ptr + bytes > m_end) {
+                advance(bytes, alignment);
+                ptr = align_up(m_bump, alignment);
+            }
+
+            m_bump = ptr + bytes;
+            return ptr;
+        }
+
+        // Makes all memory available again without returning it to the system. Objects that still live in the
+        // arena must not be used afterwards.
+        void reset() noexcept {
+            if (m_first != nullptr) {
+                enter(m_first);
+            }
+        }
+
+        // Returns all memory to the system.
+        void release() noexcept {
+            while (m_first != nullptr) {
+                auto next = m_first->next;
+                ::operator delete(m_first);
+                m_first = next;
+            }
+
+            m_current = nullptr;
+            m_bump = nullptr;
+            m_end = nullptr;
+        }
+    };
+
+    // Allocates from an arena. Deallocation does nothing, and boxes using this allocator skip it entirely (see
+    // `allocator_releases_in_bulk`). The allocator propagates with its elements, so moving boxes between arenas
+    // never copies. In turn, a box that is move assigned or swapped from a box of another arena takes over that
+    // arena: its element lives there, and that arena has to outlive the box.
+    template <typename T>
+    class arena_allocator {
+        private:
+        template <typename U>
+        friend class arena_allocator;
+
+        arena* m_arena;
+
+        template <typename U>
+        auto shares_with(arena_allocator<U> const& other) const noexcept -> bool {
+            return m_arena == other.m_arena;
+        }
+
+        public:
+        using value_type = T;
+        using propagate_on_container_copy_assignment = std::true_type;
+        using propagate_on_container_move_assignment = std::true_type;
+        using propagate_on_container_swap = std::true_type;
+        using releases_in_bulk = std::true_type;
+
+        template <typename U>
+        struct rebind {
+            using other = arena_allocator<U>;
+        };
+
+        arena_allocator(arena& a) noexcept : m_arena(&a) {}
+
+        template <typename U>
+        arena_allocator(arena_allocator<U> const& other) noexcept : m_arena(other.m_arena) {}
+
+        auto allocate(std::size_t n) -> T* {
+            return static_cast<T*>(m_arena->allocate(n * sizeof(T), alignof(T)));
+        }
+
+        void deallocate(T*, std::size_t) noexcept {}
+
+        auto resource() const noexcept -> arena& {
+            return *m_arena;
+        }
+
+        template <typename U>
+        friend auto operator==(arena_allocator const& a, arena_allocator<U> const& b) noexcept -> bool {
+            return a.shares_with(b);
+        }
+
+        template <typename U>
+        friend auto operator!=(arena_allocator const& a, arena_allocator<U> const& b) noexcept -> bool {
+            return !(a == b);
+        }
+    };
+}
+
+#endif // BEN_ARENA_ALLOCATOR_HPP
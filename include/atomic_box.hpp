@@ -0,0 +1,147 @@
+#ifndef BEN_ATOMIC_BOX_HPP
+#define BEN_ATOMIC_BOX_HPP
+
+#include "box.hpp"
+#include "epoch.hpp"
+
+#include <atomic>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace ben {
+
+    // Publishes boxed values to other threads without locks. Readers `load` a guard through which they can look
+    // at the current value for as long as they hold it, even if a writer replaces it in the meantime; replaced
+    // values are retired into an epoch domain and destroyed once no reader can be looking at them anymore.
+    // Readers never block, and writers only do in `exchange`, which has to wait for readers to hand back the old
+    // value.
+    //
+    // Published values are immutable. The allocator has to be always equal, since values are destroyed by the
+    // domain long after they have left their box.
+    template <typename T, typename Allocator = std::allocator<T>>
+    class atomic_box {
+        private:
+        using m_traits = std::allocator_traits<Allocator>;
+
+        static_assert(m_traits::is_always_equal::value, "atomic_box requires an allocator that is always equal");
+        static_assert(std::is_same_v<typename m_traits::pointer, T*>, "atomic_box requires raw pointers");
+
+        public:
+        using value_type = T;
+        using box_type = box<T, Allocator>;
+
+        // A read-side critical section along with the value that was current when it began.
+        class guard {
+            private:
+            epoch_guard m_epoch;
+            T const* m_ptr;
+
+            friend class atomic_box;
+
+            guard(epoch_guard epoch, T const* ptr) noexcept : m_epoch(std::move(epoch)), m_ptr(ptr) {}
+
+            public:
+            auto has_value() const noexcept -> bool {
+                return m_ptr != nullptr;
+            }
+
+            explicit operator bool() const noexcept {
+                return has_value();
+            }
+
+            auto get() const noexcept -> T const* {
+                return m_ptr;
+            }
+
+            auto value() const noexcept -> T const& {
+                return *m_ptr;
+            }
+
+            auto operator*() const noexcept -> T const& {
+                return *m_ptr;
+            }
+
+            auto operator->() const noexcept -> T const* {
+                return m_ptr;
+            }
+        };
+
+        private:
+        std::atomic<T*> m_ptr;
+        epoch_domain* m_domain;
+
+        static void destroy(void* ptr) noexcept {
+            static_cast<void>(detail::box_access::adopt<box_type>(static_cast<T*>(ptr), Allocator()));
+        }
+
+        void retire(T* ptr) {
+            if (ptr != nullptr) {
+                m_domain->retire(ptr, &destroy);
+            }
+        }
+
+        public:
+        explicit atomic_box(epoch_domain& domain = epoch_domain::global()) noexcept
+            : m_ptr(nullptr), m_domain(&domain) {}
+
+        explicit atomic_box(box_type value, epoch_domain& domain = epoch_domain::global()) noexcept
+            : m_ptr(value.release()), m_domain(&domain) {}
+
+        atomic_box(atomic_box const&) = delete;
+        auto operator=(atomic_box const&) -> atomic_box& = delete;
+
+        // Readers may still hold guards for the current value, so it is retired as well.
+        ~atomic_box() {
+            retire(m_ptr.load(std::memory_order_acquire));
+        }
+
+        auto domain() const noexcept -> epoch_domain& {
+            return *m_domain;
+        }
+
+        auto is_lock_free() const noexcept -> bool {
+            return m_ptr.is_lock_free();
+        }
+
+        auto load() const -> guard {
+            auto epoch = m_domain->pin();
+            return guard(std::move(epoch), m_ptr.load(std::memory_order_seq_cst));
+        }
+
+        // Publishes `value` and retires the old one.
+        void store(box_type value) {
+            retire(m_ptr.exchange(value.release(), std::memory_order_seq_cst));
+        }
+
+        // Publishes `value` and returns the old one, once no reader is looking at it anymore. Must not be called
+        // while holding a guard.
+        auto exchange(box_type value) -> box_type {
+            auto old = m_ptr.exchange(value.release(), std::memory_order_seq_cst);
+
+            if (old != nullptr) {
+                m_domain->synchronize();
+            }
+
+            return detail::box_access::adopt<box_type>(old, Allocator());
+        }
+
+        // Publishes `desired` only if the current value is still the one `expected` was loaded with, and retires
+        // that one. Since `expected` keeps its value alive, it cannot have been replaced by another value at the
+        // same address in the meantime. On failure, `desired` keeps its value.
+        auto compare_exchange(guard const& expected, box_type& desired) -> bool {
+            auto old = const_cast<T*>(expected.get());
+            auto ptr = desired.release();
+
+            if (m_ptr.compare_exchange_strong(old, ptr, std::memory_order_seq_cst)) {
+                retire(old);
+                return true;
+            }
+
+            desired = detail::box_access::adopt<box_type>(ptr, Allocator());
+            return false;
+        }
+    };
+}
+
+#endif // BEN_ATOMIC_BOX_HPP
@@ -1,9 +1,12 @@
 #ifndef BEN_BOX_HPP
 #define BEN_BOX_HPP
 
+#include <cstdint>
 #include <functional>
 #include <memory>
+#include <memory_resource>
 #include <optional>
+#include <type_traits>
 #include <utility>
 
 namespace ben {
@@ -11,24 +14,274 @@ namespace ben {
     namespace detail {
         // Thanks to p0653 for providing this idiom. 
         // C++20: Replace this implementation with `std::to_address`.
+        // The overload for raw pointers has to come first, so that fancy pointers can find it.
         template <typename T>
-        auto to_address(T const& ptr) noexcept {
-            return to_address(ptr.operator->());
+        auto to_address(T* ptr) noexcept -> T* {
+            return ptr;
         }
 
         template <typename T>
-        auto to_address(T* ptr) noexcept -> T* {
-            return ptr;
+        auto to_address(T const& ptr) noexcept {
+            return to_address(ptr.operator->());
         }
+
+        // Stores `First` as a base class whenever possible, so that empty types (most notably stateless
+        // allocators) take up no space thanks to the empty base optimization.
+        template <typename First, typename Second, bool = std::is_empty_v<First> && !std::is_final_v<First>>
+        class compressed_pair : private First {
+            private:
+            Second m_second;
+
+            public:
+            compressed_pair() = default;
+
+            template <typename F>
+            explicit compressed_pair(F&& first) : First(std::forward<F>(first)), m_second() {}
+
+            template <typename F, typename S>
+            compressed_pair(F&& first, S&& second)
+                : First(std::forward<F>(first)), m_second(std::forward<S>(second)) {}
+
+            auto first() noexcept -> First& {
+                return *this;
+            }
+
+            auto first() const noexcept -> First const& {
+                return *this;
+            }
+
+            auto second() noexcept -> Second& {
+                return m_second;
+            }
+
+            auto second() const noexcept -> Second const& {
+                return m_second;
+            }
+        };
+
+        template <typename First, typename Second>
+        class compressed_pair<First, Second, false> {
+            private:
+            First m_first;
+            Second m_second;
+
+            public:
+            compressed_pair() = default;
+
+            template <typename F>
+            explicit compressed_pair(F&& first) : m_first(std::forward<F>(first)), m_second() {}
+
+            template <typename F, typename S>
+            compressed_pair(F&& first, S&& second)
+                : m_first(std::forward<F>(first)), m_second(std::forward<S>(second)) {}
+
+            auto first() noexcept -> First& {
+                return m_first;
+            }
+
+            auto first() const noexcept -> First const& {
+                return m_first;
+            }
+
+            auto second() noexcept -> Second& {
+                return m_second;
+            }
+
+            auto second() const noexcept -> Second const& {
+                return m_second;
+            }
+        };
+
     }
 
-    template <typename T, typename Allocator = std::allocator<T>>
+    // Keeps a separate flag signalling whether the element is alive. Works with any (fancy) pointer type.
+    struct flag_layout {
+        template <typename T, typename Pointer>
+        class state {
+            private:
+            Pointer m_ptr = nullptr;
+            bool m_has_value = false;
+
+            public:
+            state() = default;
+            state(Pointer ptr, bool has_value) noexcept : m_ptr(ptr), m_has_value(has_value) {}
+
+            auto ptr() const noexcept -> Pointer {
+                return m_ptr;
+            }
+
+            auto has_value() const noexcept -> bool {
+                return m_has_value;
+            }
+
+            void set_ptr(Pointer ptr) noexcept {
+                m_ptr = ptr;
+            }
+
+            void set_has_value(bool has_value) noexcept {
+                m_has_value = has_value;
+            }
+        };
+    };
+
+    // Stores the flag in the lowest bit of the pointer, which is always zero for types aligned to two bytes or
+    // more. Only applicable to raw pointers.
+    struct tagged_layout {
+        template <typename T, typename Pointer>
+        class state {
+            static_assert(std::is_same_v<Pointer, T*>, "tagged_layout requires the allocator to use raw pointers");
+            static_assert(alignof(T) >= 2, "tagged_layout requires the alignment of T to leave a bit unused");
+
+            private:
+            static constexpr std::uintptr_t m_tag = 1;
+
+            std::uintptr_t m_bits = 0;
+
+            public:
+            state() = default;
+            state(Pointer ptr, bool has_value) noexcept
+                : m_bits(reinterpret_cast<std::uintptr_t>(ptr) | (has_value ? m_tag : 0)) {}
+
+            auto ptr() const noexcept -> Pointer {
+                return reinterpret_cast<Pointer>(m_bits & ~m_tag);
+            }
+
+            auto has_value() const noexcept -> bool {
+                return (m_bits & m_tag) != 0;
+            }
+
+            void set_ptr(Pointer ptr) noexcept {
+                m_bits = reinterpret_cast<std::uintptr_t>(ptr) | (m_bits & m_tag);
+            }
+
+            void set_has_value(bool has_value) noexcept {
+                m_bits = has_value ? (m_bits | m_tag) : (m_bits & ~m_tag);
+            }
+        };
+    };
+
+    // Uses `tagged_layout` wherever possible and falls back to `flag_layout` for fancy pointers and byte-aligned
+    // types.
+    struct default_layout {
+        template <typename T, typename Pointer>
+        using state = typename std::conditional_t<std::is_same_v<Pointer, T*> && alignof(T) >= 2,
+            tagged_layout, flag_layout>::template state<T, Pointer>;
+    };
+
+    // Allocators whose memory is given back all at once, such as arenas, can declare
+    // `using releases_in_bulk = std::true_type;`. Boxes then skip deallocating their storage, and also skip
+    // destroying trivially destructible elements, so that tearing them down costs nothing.
+    template <typename Allocator, typename = void>
+    struct allocator_releases_in_bulk : std::false_type {};
+
+    template <typename Allocator>
+    struct allocator_releases_in_bulk<Allocator, std::void_t<typename Allocator::releases_in_bulk>>
+        : Allocator::releases_in_bulk {};
+
+    template <typename Allocator>
+    inline constexpr bool allocator_releases_in_bulk_v = allocator_releases_in_bulk<Allocator>::value;
+
+    // Whether moving an object to a new address and ending the lifetime of the old one can be done by copying its
+    // bytes, i.e. the object does not refer to its own address and does not care where it lives. Types that are
+    // not trivially copyable can opt in by specializing this trait. See `relocate.hpp` for algorithms using it.
+    template <typename T>
+    struct is_trivially_relocatable : std::is_trivially_copyable<T> {};
+
+    // Neither the standard allocator nor a pointer to a memory resource care about their address, even though
+    // their copy constructors may be user-provided.
+    template <typename T>
+    struct is_trivially_relocatable<std::allocator<T>> : std::true_type {};
+
+    template <typename T>
+    struct is_trivially_relocatable<std::pmr::polymorphic_allocator<T>> : std::true_type {};
+
+    template <typename T>
+    inline constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
+    // Strategies for replacing the element of a box that already holds one, used by `emplace` and `push`.
+    //
+    // Builds a temporary and move-assigns it, or assigns arguments of the element type directly. If building
+    // the temporary throws, the old element is left untouched.
+    struct assign_emplace {};
+
+    // Destroys the old element and constructs the new one in its place, without a temporary and without
+    // requiring the element type to be assignable. If the constructor throws, the box is left empty but keeps
+    // its storage. The arguments must not refer to the element that is being replaced.
+    struct reconstruct_emplace {};
+
+    // Assigns arguments of the element type directly, so that e.g. strings can reuse their capacity, and
+    // reconstructs when the arguments are arithmetic or enumeration values and constructing from them cannot throw.
+    // Those are copied before the old element is destroyed, in case they refer to a part of it. Arguments of any
+    // other type may refer to the element, as in `b.emplace(std::move(*b.value()))`, so they go through
+    // `assign_emplace`. Only element types that are not move assignable fall back to `reconstruct_emplace`, with
+    // its restriction on the arguments.
+    struct adaptive_emplace {};
+
+    namespace detail {
+        template <typename T, typename... Args>
+        inline constexpr bool is_direct_assignment = false;
+
+        template <typename T, typename Arg>
+        inline constexpr bool is_direct_assignment<T, Arg> = std::is_same_v<std::decay_t<Arg>, T>
+            && std::is_assignable_v<T&, Arg&&>;
+
+        // Arguments that can be copied without touching anything they might refer to.
+        template <typename... Args>
+        inline constexpr bool are_plain_values = ((std::is_arithmetic_v<std::remove_reference_t<Args>>
+                                                   || std::is_enum_v<std::remove_reference_t<Args>>) && ...);
+
+        template <typename Strategy, typename T, typename... Args>
+        inline constexpr bool copies_arguments = std::is_same_v<Strategy, adaptive_emplace>
+            && are_plain_values<Args...> && std::is_constructible_v<T, std::decay_t<Args>...>;
+
+        template <typename Strategy, typename T, typename... Args>
+        inline constexpr bool reconstructs = std::is_same_v<Strategy, reconstruct_emplace>
+            || (std::is_same_v<Strategy, adaptive_emplace> && !is_direct_assignment<T, Args...>
+                && ((copies_arguments<Strategy, T, Args...>
+                     && std::is_nothrow_constructible_v<T, std::decay_t<Args>...>)
+                    || !std::is_move_assignable_v<T>));
+    }
+
+    // Policies for the storage of a box whose element is erased.
+    //
+    // Keeps the storage around, so that a later `emplace` or `push` does not have to allocate. It is only given
+    // back by `reset`, `shrink_to_fit` or the destructor.
+    struct retain_storage {};
+
+    // Gives the storage back right away, for boxes that stay empty for a long time.
+    struct release_storage {};
+
+    // Customization point for the behaviour of box. Custom policies should derive from this type and only
+    // override the members they want to change.
+    struct default_box_policy {
+        using layout = default_layout;
+        using emplace_strategy = adaptive_emplace;
+        using storage_strategy = retain_storage;
+    };
+
+    template <typename T, typename Allocator = std::allocator<T>, typename Policy = default_box_policy>
     class box; 
 
-    template <typename T, typename Allocator>
-    void swap(box<T, Allocator>& a, box<T, Allocator>& b); 
+    template <typename T, typename Allocator, typename Policy>
+    void swap(box<T, Allocator, Policy>& a, box<T, Allocator, Policy>& b) noexcept; 
+
+    namespace detail {
+        struct box_access;
+
+        // Whether an element created by `new T` can be handed to a box and back: `std::allocator` gets its memory
+        // from the same global `operator new`, unless `T` brings its own. Boxes also deallocate exactly `sizeof(T)`
+        // bytes, so the element must not be of a larger derived type.
+        template <typename T, typename Allocator, typename = void>
+        struct unique_ptr_compatible
+            : std::bool_constant<std::is_same_v<Allocator, std::allocator<T>> && !std::is_array_v<T>
+                                 && (!std::is_polymorphic_v<T> || std::is_final_v<T>)> {};
+
+        template <typename T, typename Allocator>
+        struct unique_ptr_compatible<T, Allocator, std::void_t<decltype(T::operator new(std::size_t()))>>
+            : std::false_type {};
+    }
 
-    template <typename T, typename Allocator>
+    template <typename T, typename Allocator, typename Policy>
     class box {
         private: 
         using m_traits = std::allocator_traits<Allocator>;
@@ -42,34 +295,85 @@ namespace ben {
         using const_reference = T const&;
         using pointer = typename m_traits::pointer;
         using const_pointer = typename m_traits::const_pointer;
-        using iterator = T*;
-        using const_iterator = T const*;
+        // Iterators are the pointers of the allocator, so that boxes with fancy pointers can be iterated without
+        // leaving their address space.
+        using iterator = pointer;
+        using const_iterator = const_pointer;
 
         private:
-        pointer m_ptr = nullptr;
-        bool m_has_value = false;
-        allocator_type m_alloc;
+        using m_state_type = typename Policy::layout::template state<T, pointer>;
+
+        static constexpr bool m_bulk_released = allocator_releases_in_bulk_v<Allocator>;
+        static constexpr bool m_releases_on_erase = std::is_same_v<typename Policy::storage_strategy,
+                                                                   release_storage>;
+
+        detail::compressed_pair<allocator_type, m_state_type> m_storage;
 
         explicit box(pointer ptr, allocator_type const& alloc)
-            : m_ptr(ptr), m_alloc(alloc), m_has_value(true) {}
+            : m_storage(alloc, m_state_type(ptr, ptr != nullptr)) {}
+
+        auto m_alloc() noexcept -> allocator_type& {
+            return m_storage.first();
+        }
+
+        auto m_alloc() const noexcept -> allocator_type const& {
+            return m_storage.first();
+        }
+
+        auto m_state() noexcept -> m_state_type& {
+            return m_storage.second();
+        }
+
+        auto m_state() const noexcept -> m_state_type const& {
+            return m_storage.second();
+        }
 
         template <typename... Args>
         void make_heap_value(Args&&... args) {
-            auto ptr = m_traits::allocate(m_alloc, 1);
-            m_traits::construct(m_alloc, detail::to_address(ptr), std::forward<Args>(args)...);
-            m_ptr = ptr;
-            m_has_value = true;
+            auto ptr = m_traits::allocate(m_alloc(), 1);
+
+            try {
+                m_traits::construct(m_alloc(), detail::to_address(ptr), std::forward<Args>(args)...);
+            } catch (...) {
+                m_traits::deallocate(m_alloc(), ptr, 1);
+                throw;
+            }
+
+            m_state() = m_state_type(ptr, true);
         } 
 
+        template <typename... Args>
+        void reconstruct_value(Args&&... args) {
+            destroy_value();
+            m_traits::construct(m_alloc(), detail::to_address(m_state().ptr()), std::forward<Args>(args)...);
+            m_state().set_has_value(true);
+        }
+
+        template <typename... Args>
+        void replace_existing_value(Args&&... args) {
+            using strategy = typename Policy::emplace_strategy;
+
+            if constexpr (detail::reconstructs<strategy, T, Args...>
+                          && detail::copies_arguments<strategy, T, Args...>) {
+                reconstruct_value(std::decay_t<Args>(args)...);
+            } else if constexpr (detail::reconstructs<strategy, T, Args...>) {
+                reconstruct_value(std::forward<Args>(args)...);
+            } else if constexpr (detail::is_direct_assignment<T, Args...>) {
+                value() = (std::forward<Args>(args), ...);
+            } else {
+                value() = value_type(std::forward<Args>(args)...);
+            }
+        }
+
         template <typename... Args>
         void replace_heap_value(Args&&... args) {
 
-            if (m_ptr != nullptr) {
-                if (m_has_value) {
-                    value() = value_type(std::forward<Args>(args)...);
+            if (m_state().ptr() != nullptr) {
+                if (m_state().has_value()) {
+                    replace_existing_value(std::forward<Args>(args)...);
                 } else {
-                    m_traits::construct(m_alloc, detail::to_address(m_ptr), std::forward<Args>(args)...);
-                    m_has_value = true;
+                    m_traits::construct(m_alloc(), detail::to_address(m_state().ptr()), std::forward<Args>(args)...);
+                    m_state().set_has_value(true);
                 }
 
             } else {
@@ -77,88 +381,120 @@ namespace ben {
             }
         }
 
-        void memory_cleanup() {
-            if (m_ptr != nullptr) {
-                m_traits::deallocate(m_alloc, detail::to_address(m_ptr), 1);
-                m_ptr = nullptr;
+        void memory_cleanup() noexcept {
+            if (m_state().ptr() != nullptr) {
+                if constexpr (!m_bulk_released) {
+                    m_traits::deallocate(m_alloc(), m_state().ptr(), 1);
+                }
+
+                m_state() = m_state_type();
+            }
+        }
+
+        void destroy_value() noexcept {
+            if (!m_state().has_value()) {
+                return;
             }
+
+            m_traits::destroy(m_alloc(), detail::to_address(m_state().ptr()));
+            m_state().set_has_value(false);
         }
 
-        void full_cleanup() {
-            erase();
+        void full_cleanup() noexcept {
+            destroy_value();
             memory_cleanup();
         }
 
         template <typename U> 
         friend auto from_raw(U* ptr) -> box<U>; 
 
-        friend void swap<T, Allocator>(box<T, Allocator>& a, box<T, Allocator>& b);
+        friend void swap<T, Allocator, Policy>(box<T, Allocator, Policy>& a, box<T, Allocator, Policy>& b) noexcept;
+
+        friend struct detail::box_access;
 
         public:
-        box() {}
-        explicit box(allocator_type const& alloc) : m_alloc(alloc) {}
+        box() noexcept(noexcept(Allocator())) {}
+        explicit box(allocator_type const& alloc) noexcept : m_storage(alloc, m_state_type()) {}
 
-        explicit box(T const& element, allocator_type const& alloc = Allocator()) : m_alloc(alloc) {
+        explicit box(T const& element, allocator_type const& alloc = Allocator()) : m_storage(alloc, m_state_type()) {
             make_heap_value(element);
         }
 
-        explicit box(T&& element, allocator_type const& alloc = Allocator()) : m_alloc(alloc) {
+        explicit box(T&& element, allocator_type const& alloc = Allocator()) : m_storage(alloc, m_state_type()) {
             make_heap_value(std::move(element));
         }
 
+        // Takes over the element of `ptr` without copying or reallocating it.
+        template <typename A = Allocator, typename = std::enable_if_t<detail::unique_ptr_compatible<T, A>::value>>
+        explicit box(std::unique_ptr<T>&& ptr) noexcept : box(ptr.release(), allocator_type()) {}
+
         box(box const& other)
-            : m_alloc(m_traits::select_on_container_copy_construction(other.m_alloc)) { 
+            : m_storage(m_traits::select_on_container_copy_construction(other.m_alloc()), m_state_type()) { 
 
-            if (other.m_has_value) {
+            if (other.m_state().has_value()) {
                 make_heap_value(other.value());
             }
         }
 
-        box(box&& other) {
-            swap(*this, other);
+        // Allocators are required not to throw when moved, so this never has to fall back to copying.
+        box(box&& other) noexcept : m_storage(std::move(other.m_alloc()), other.m_state()) {
+            other.m_state() = m_state_type();
         }
 
         ~box() {
-            erase();
+            if constexpr (!m_bulk_released || !std::is_trivially_destructible_v<T>) {
+                destroy_value();
+            }
 
-            if (m_ptr != nullptr) {
-                m_traits::deallocate(m_alloc, detail::to_address(m_ptr), 1);
+            if constexpr (!m_bulk_released) {
+                if (m_state().ptr() != nullptr) {
+                    m_traits::deallocate(m_alloc(), m_state().ptr(), 1);
+                }
             }
         }
 
+        // Allocators that do not propagate keep their own memory, the element is copied into it instead.
         auto operator=(box const& other) -> box& {
-            if (m_traits::propagate_on_container_copy_assignment::value || m_alloc != other.m_alloc) {
-                memory_cleanup();
+            if (this == &other) {
+                return *this;
+            }
 
-                m_alloc = other.m_alloc;
-                if (other.has_value()) {
-                    make_heap_value(other.value());
+            if constexpr (m_traits::propagate_on_container_copy_assignment::value) {
+                if (m_alloc() != other.m_alloc()) {
+                    full_cleanup();
                 }
+
+                m_alloc() = other.m_alloc();
+            }
+
+            if (other.has_value()) {
+                replace_heap_value(other.value());
             } else {
-                if (other.has_value()) {
-                    replace_heap_value(other.value());
-                } else {
-                    erase();
-                }
+                erase();
             }
 
             return *this;
         }
 
-        auto operator=(box&& other) -> box& {
+        // Only stealing the pointer is guaranteed not to throw; with unequal allocators that do not propagate, the
+        // element has to be moved over into memory from our own allocator instead.
+        auto operator=(box&& other) noexcept(m_traits::propagate_on_container_move_assignment::value
+                                             || m_traits::is_always_equal::value) -> box& {
             using std::swap;
 
-            if (m_traits::is_always_equal::value || m_alloc == other.m_alloc) {
+            if (this == &other) {
+                return *this;
+            }
+
+            if (m_traits::is_always_equal::value || m_alloc() == other.m_alloc()) {
                 full_cleanup();
 
-                swap(m_ptr, other.m_ptr);
-                swap(m_has_value, other.m_has_value);
+                swap(m_state(), other.m_state());
             } else if constexpr (m_traits::propagate_on_container_move_assignment::value) {
                 full_cleanup();
 
-                swap(m_ptr, other.m_ptr);
-                swap(m_has_value, other.m_has_value);
-                m_alloc = std::move(other.m_alloc);
+                swap(m_state(), other.m_state());
+                m_alloc() = std::move(other.m_alloc());
             } else {
                 if (other.has_value()) {
                     replace_heap_value(std::move(other.value()));
@@ -170,48 +506,48 @@ namespace ben {
             return *this;
         }
 
-        auto get_allocator() const -> allocator_type {
-            return m_alloc;
+        auto get_allocator() const noexcept -> allocator_type {
+            return m_alloc();
         }
 
-        auto value() -> reference {
-            return *m_ptr;
+        auto value() noexcept -> reference {
+            return *m_state().ptr();
         }
 
-        auto value() const -> const_reference {
-            return *m_ptr;
+        auto value() const noexcept -> const_reference {
+            return *m_state().ptr();
         }
 
-        auto operator*() -> reference {
+        auto operator*() noexcept -> reference {
             return value();
         }
 
-        auto operator*() const -> const_reference {
+        auto operator*() const noexcept -> const_reference {
             return value();
         }
 
-        auto safe_value() -> std::optional<std::reference_wrapper<value_type>> {
-            if (m_has_value) {
+        auto safe_value() noexcept -> std::optional<std::reference_wrapper<value_type>> {
+            if (m_state().has_value()) {
                 return value();
             }
 
             return std::nullopt;
         }
 
-        auto safe_value() const -> std::optional<std::reference_wrapper<value_type const>> {
-            if (m_has_value) {
+        auto safe_value() const noexcept -> std::optional<std::reference_wrapper<value_type const>> {
+            if (m_state().has_value()) {
                 return value();
             }
 
             return std::nullopt;
         }
 
-        auto has_value() const -> bool {
-            return m_has_value;
+        auto has_value() const noexcept -> bool {
+            return m_state().has_value();
         }
 
-        auto size() const -> size_type {
-            return m_has_value ? 1 : 0;
+        auto size() const noexcept -> size_type {
+            return m_state().has_value() ? 1 : 0;
         }
 
         template <typename... Args>
@@ -227,52 +563,96 @@ namespace ben {
             replace_heap_value(std::move(val));
         }
 
-        void erase() {
-            if (!m_has_value) {
-                return;
+        // Whether the storage is retained after `erase` depends on the storage strategy of the policy.
+        void erase() noexcept {
+            destroy_value();
+
+            if constexpr (m_releases_on_erase) {
+                memory_cleanup();
+            }
+        }
+
+        // Destroys the element and gives back the storage.
+        void reset() noexcept {
+            full_cleanup();
+        }
+
+        // Hands the element over to the caller, who has to destroy it and give back its storage through an
+        // allocator equal to `get_allocator()`. Leaves the box empty and without storage; returns null, after
+        // giving back any retained storage, if there was no element.
+        auto release() noexcept -> pointer {
+            if (!m_state().has_value()) {
+                memory_cleanup();
+                return nullptr;
+            }
+
+            auto ptr = m_state().ptr();
+            m_state() = m_state_type();
+            return ptr;
+        }
+
+        // Hands the element over to a `std::unique_ptr` without copying or reallocating it.
+        template <typename A = Allocator, typename = std::enable_if_t<detail::unique_ptr_compatible<T, A>::value>>
+        auto into_unique() && noexcept -> std::unique_ptr<T> {
+            return std::unique_ptr<T>(release());
+        }
+
+        // The number of elements the box can hold without allocating, i.e. 1 if it owns storage and 0 otherwise.
+        auto capacity() const noexcept -> size_type {
+            return m_state().ptr() != nullptr ? 1 : 0;
+        }
+
+        // Allocates storage up front, so that the next `emplace` or `push` cannot fail to allocate.
+        void reserve() {
+            if (m_state().ptr() == nullptr) {
+                m_state() = m_state_type(m_traits::allocate(m_alloc(), 1), false);
             }
+        }
 
-            m_traits::destroy(m_alloc, detail::to_address(m_ptr));
-            m_has_value = false;
+        // Gives back the storage of an empty box.
+        void shrink_to_fit() noexcept {
+            if (!m_state().has_value()) {
+                memory_cleanup();
+            }
         }
 
-        auto begin() -> iterator {
-            if (!m_has_value) {
+        auto begin() noexcept -> iterator {
+            if (!m_state().has_value()) {
                 return nullptr;
             }
 
-            return detail::to_address(m_ptr);
+            return m_state().ptr();
         }
 
-        auto begin() const -> const_iterator {
-            if (!m_has_value) {
+        auto begin() const noexcept -> const_iterator {
+            if (!m_state().has_value()) {
                 return nullptr;
             }
 
-            return detail::to_address(m_ptr);
+            return m_state().ptr();
         }
 
-        auto end() -> iterator {
-            if (!m_has_value) {
+        auto end() noexcept -> iterator {
+            if (!m_state().has_value()) {
                 return nullptr;
             }
             
-            return detail::to_address(m_ptr) + 1;
+            return m_state().ptr() + 1;
         }
 
-        auto end() const -> const_iterator {
-            if (!m_has_value) {
+        auto end() const noexcept -> const_iterator {
+            if (!m_state().has_value()) {
                 return nullptr;
             }
             
-            return detail::to_address(m_ptr) + 1;
+            return m_state().ptr() + 1;
         }
 
-        auto cbegin() const -> const_iterator {
+        auto cbegin() const noexcept -> const_iterator {
             return begin();
         }
 
-        auto cend() const -> const_iterator {
+        auto cend() const noexcept -> const_iterator {
             return end();
         }
     };
@@ -282,17 +662,129 @@ namespace ben {
        return box<U>(ptr, std::allocator<U>()); 
     }
 
-    template <typename T, typename Allocator>
-    void swap(box<T, Allocator>& a, box<T, Allocator>& b) {
+    template <typename T, typename Allocator, typename Policy>
+    void swap(box<T, Allocator, Policy>& a, box<T, Allocator, Policy>& b) noexcept {
         using std::swap;
 
         if constexpr (std::allocator_traits<Allocator>::propagate_on_container_swap::value) {
-            swap(a.m_alloc, b.m_alloc);
+            swap(a.m_alloc(), b.m_alloc());
+        }
+
+        swap(a.m_state(), b.m_state());
+    }
+
+    // Boxes compare by their elements, like `std::optional`: two empty boxes are equal, and an empty box is less
+    // than any box holding an element.
+    template <typename T, typename A1, typename P1, typename U, typename A2, typename P2>
+    auto operator==(box<T, A1, P1> const& a, box<U, A2, P2> const& b) -> bool {
+        if (a.has_value() != b.has_value()) {
+            return false;
         }
 
-        swap(a.m_ptr, b.m_ptr);
-        swap(a.m_has_value, b.m_has_value);
+        return !a.has_value() || a.value() == b.value();
     }
+
+    template <typename T, typename A1, typename P1, typename U, typename A2, typename P2>
+    auto operator!=(box<T, A1, P1> const& a, box<U, A2, P2> const& b) -> bool {
+        return !(a == b);
+    }
+
+    template <typename T, typename A1, typename P1, typename U, typename A2, typename P2>
+    auto operator<(box<T, A1, P1> const& a, box<U, A2, P2> const& b) -> bool {
+        if (!b.has_value()) {
+            return false;
+        }
+
+        return !a.has_value() || a.value() < b.value();
+    }
+
+    template <typename T, typename A1, typename P1, typename U, typename A2, typename P2>
+    auto operator>(box<T, A1, P1> const& a, box<U, A2, P2> const& b) -> bool {
+        return b < a;
+    }
+
+    template <typename T, typename A1, typename P1, typename U, typename A2, typename P2>
+    auto operator<=(box<T, A1, P1> const& a, box<U, A2, P2> const& b) -> bool {
+        return !(b < a);
+    }
+
+    template <typename T, typename A1, typename P1, typename U, typename A2, typename P2>
+    auto operator>=(box<T, A1, P1> const& a, box<U, A2, P2> const& b) -> bool {
+        return !(a < b);
+    }
+
+    namespace detail {
+        // Lets other parts of the library hand an element taken out with `release` back to a box, e.g. after
+        // publishing it through an atomic pointer.
+        struct box_access {
+            // Takes ownership of an element allocated from an allocator equal to `alloc`, or of nothing if `ptr`
+            // is null.
+            template <typename Box>
+            static auto adopt(typename Box::pointer ptr, typename Box::allocator_type const& alloc) -> Box {
+                return Box(ptr, alloc);
+            }
+
+            // Hands a box that has no storage an element allocated from `alloc`, and `alloc` itself, no matter
+            // whether the allocator would propagate.
+            template <typename T, typename Allocator, typename Policy>
+            static void reseat(box<T, Allocator, Policy>& b, typename box<T, Allocator, Policy>::pointer ptr,
+                               Allocator const& alloc) noexcept {
+                b.m_alloc() = alloc;
+                b.m_state() = typename box<T, Allocator, Policy>::m_state_type(ptr, ptr != nullptr);
+            }
+        };
+    }
+
+    // A box only consists of its allocator and a pointer, neither of which usually cares about its address. The
+    // element itself stays where it is.
+    template <typename T, typename Allocator, typename Policy>
+    struct is_trivially_relocatable<box<T, Allocator, Policy>>
+        : std::bool_constant<is_trivially_relocatable_v<Allocator>
+                             && is_trivially_relocatable_v<typename std::allocator_traits<Allocator>::pointer>> {};
+
+    // Takes ownership of an element constructed in storage allocated from an allocator equal to `alloc`, or of
+    // nothing if `ptr` is null.
+    template <typename Policy = default_box_policy, typename Allocator>
+    auto from_raw(typename std::allocator_traits<Allocator>::pointer ptr, Allocator const& alloc)
+        -> box<typename std::allocator_traits<Allocator>::value_type, Allocator, Policy> {
+        using box_type = box<typename std::allocator_traits<Allocator>::value_type, Allocator, Policy>;
+        return detail::box_access::adopt<box_type>(ptr, alloc);
+    }
+
+    namespace detail {
+        // The hash of every empty box. Any value will do, as long as it is always the same.
+        inline constexpr std::size_t empty_box_hash = static_cast<std::size_t>(-3333);
+
+        // Like `std::hash<std::optional<T>>`, only enabled if `T` can be hashed.
+        template <typename T, typename = void>
+        struct box_hash {
+            box_hash() = delete;
+            box_hash(box_hash const&) = delete;
+            auto operator=(box_hash const&) -> box_hash& = delete;
+        };
+
+        template <typename T>
+        struct box_hash<T, std::void_t<decltype(std::hash<T>()(std::declval<T const&>()))>> {
+            template <typename Box>
+            auto operator()(Box const& b) const -> std::size_t {
+                return b.has_value() ? std::hash<T>()(b.value()) : empty_box_hash;
+            }
+        };
+    }
+
+    namespace pmr {
+        // Boxes whose memory comes from a `std::pmr::memory_resource`. Like the standard containers, they do not
+        // propagate their resource on assignment: moving between boxes with different resources moves the element
+        // over instead of stealing the pointer.
+        template <typename T>
+        using box = ben::box<T, std::pmr::polymorphic_allocator<T>>;
+    }
+}
+
+namespace std {
+    // Hashes the element, so that equal boxes have equal hashes.
+    template <typename T, typename Allocator, typename Policy>
+    struct hash<ben::box<T, Allocator, Policy>> : ben::detail::box_hash<std::remove_const_t<T>> {};
 }
 
 #endif // BEN_BOX_HPP
@@ -0,0 +1,101 @@
+#ifndef BEN_COMPACT_HPP
+#define BEN_COMPACT_HPP
+
+#include "box.hpp"
+#include "relocate.hpp"
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+
+namespace ben {
+
+    namespace detail {
+        template <typename Box>
+        void compact_one(Box& b, typename Box::pointer slot, typename Box::allocator_type const& alloc) {
+            using traits = std::allocator_traits<typename Box::allocator_type>;
+
+            auto old_alloc = b.get_allocator();
+            auto old_ptr = b.release();
+
+            try {
+                uninitialized_relocate(to_address(old_ptr), to_address(old_ptr) + 1, to_address(slot));
+            } catch (...) {
+                box_access::reseat(b, old_ptr, old_alloc);
+                throw;
+            }
+
+            if constexpr (!allocator_releases_in_bulk_v<typename Box::allocator_type>) {
+                traits::deallocate(old_alloc, old_ptr, 1);
+            }
+
+            box_access::reseat(b, slot, alloc);
+        }
+
+        // Gives up whatever storage an empty box retained.
+        template <typename Box>
+        void compact_empty(Box& b, typename Box::allocator_type const& alloc) noexcept {
+            static_cast<void>(b.release());
+            box_access::reseat(b, nullptr, alloc);
+        }
+    }
+
+    // Moves the elements of the boxes in [first, last) into `arena`, next to each other and in the order of the
+    // range, and makes the boxes allocate from `arena` from then on. Boxes keep their values; only where the values
+    // live changes, so that scanning the range no longer jumps around in memory. Empty boxes give up any storage
+    // they retained.
+    //
+    // The allocator of the boxes has to be constructible from `Arena&`, like `arena_allocator` is from `arena`.
+    // Allocators that release in bulk hand out a single block for all elements; others are asked for one element
+    // at a time, which with a bump allocator amounts to the same. Trivially relocatable elements are copied
+    // bytewise. If moving an element throws, that box keeps its old element and the boxes before it stay compacted.
+    template <typename ForwardIt, typename Arena>
+    void compact(ForwardIt first, ForwardIt last, Arena& arena) {
+        using box_type = typename std::iterator_traits<ForwardIt>::value_type;
+        using allocator_type = typename box_type::allocator_type;
+        using traits = std::allocator_traits<allocator_type>;
+
+        static_assert(std::is_constructible_v<allocator_type, Arena&>,
+                      "compact requires an allocator that can be constructed from the arena");
+
+        auto alloc = allocator_type(arena);
+
+        if constexpr (allocator_releases_in_bulk_v<allocator_type>) {
+            auto count = std::size_t(0);
+
+            for (auto it = first; it != last; ++it) {
+                count += it->has_value() ? 1 : 0;
+            }
+
+            auto slot = count == 0 ? nullptr : traits::allocate(alloc, count);
+
+            for (; first != last; ++first) {
+                if (first->has_value()) {
+                    detail::compact_one(*first, slot, alloc);
+                    ++slot;
+                } else {
+                    detail::compact_empty(*first, alloc);
+                }
+            }
+        } else {
+            for (; first != last; ++first) {
+                if (!first->has_value()) {
+                    detail::compact_empty(*first, alloc);
+                    continue;
+                }
+
+                auto slot = traits::allocate(alloc, 1);
+
+                try {
+                    detail::compact_one(*first, slot, alloc);
+                } catch (...) {
+                    traits::deallocate(alloc, slot, 1);
+                    throw;
+                }
+            }
+        }
+    }
+}
+
+#endif // BEN_COMPACT_HPP
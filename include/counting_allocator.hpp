@@ -0,0 +1,177 @@
+#ifndef BEN_COUNTING_ALLOCATOR_HPP
+#define BEN_COUNTING_ALLOCATOR_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace ben {
+
+    struct allocation_stats {
+        std::size_t allocations = 0;
+        std::size_t deallocations = 0;
+        std::size_t constructions = 0;
+        std::size_t destructions = 0;
+        std::size_t bytes_allocated = 0;
+        std::size_t bytes_deallocated = 0;
+
+        auto live_allocations() const noexcept -> std::size_t {
+            return allocations - deallocations;
+        }
+
+        auto live_bytes() const noexcept -> std::size_t {
+            return bytes_allocated - bytes_deallocated;
+        }
+    };
+
+    namespace detail {
+        class atomic_allocation_stats {
+            private:
+            std::atomic<std::size_t> m_allocations{0};
+            std::atomic<std::size_t> m_deallocations{0};
+            std::atomic<std::size_t> m_constructions{0};
+            std::atomic<std::size_t> m_destructions{0};
+            std::atomic<std::size_t> m_bytes_allocated{0};
+            std::atomic<std::size_t> m_bytes_deallocated{0};
+
+            public:
+            void allocated(std::size_t bytes) noexcept {
+                m_allocations.fetch_add(1, std::memory_order_relaxed);
+                m_bytes_allocated.fetch_add(bytes, std::memory_order_relaxed);
+            }
+
+            void deallocated(std::size_t bytes) noexcept {
+                m_deallocations.fetch_add(1, std::memory_order_relaxed);
+                m_bytes_deallocated.fetch_add(bytes, std::memory_order_relaxed);
+            }
+
+            void constructed() noexcept {
+                m_constructions.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            void destroyed() noexcept {
+                m_destructions.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            auto snapshot() const noexcept -> allocation_stats {
+                return {
+                    m_allocations.load(std::memory_order_relaxed),
+                    m_deallocations.load(std::memory_order_relaxed),
+                    m_constructions.load(std::memory_order_relaxed),
+                    m_destructions.load(std::memory_order_relaxed),
+                    m_bytes_allocated.load(std::memory_order_relaxed),
+                    m_bytes_deallocated.load(std::memory_order_relaxed)
+                };
+            }
+
+            void reset() noexcept {
+                m_allocations = 0;
+                m_deallocations = 0;
+                m_constructions = 0;
+                m_destructions = 0;
+                m_bytes_allocated = 0;
+                m_bytes_deallocated = 0;
+            }
+        };
+
+        template <typename Tag>
+        inline atomic_allocation_stats counting_allocator_stats;
+    }
+
+    // Forwards everything to `Upstream` and counts allocations, deallocations, constructions and destructions,
+    // along with the bytes involved. The counters are shared by all allocators with the same `Tag`, which is kept
+    // when rebinding, so that there is one set per box type even if the box allocates something other than `T`.
+    template <typename T, typename Upstream = std::allocator<T>, typename Tag = T>
+    class counting_allocator : private Upstream {
+        private:
+        using m_traits = std::allocator_traits<Upstream>;
+
+        template <typename U, typename UUpstream, typename UTag>
+        friend class counting_allocator;
+
+        static constexpr auto& m_stats = detail::counting_allocator_stats<Tag>;
+
+        auto upstream() noexcept -> Upstream& {
+            return *this;
+        }
+
+        public:
+        using value_type = T;
+        using pointer = typename m_traits::pointer;
+        using const_pointer = typename m_traits::const_pointer;
+        using size_type = typename m_traits::size_type;
+        using difference_type = typename m_traits::difference_type;
+        using propagate_on_container_copy_assignment = typename m_traits::propagate_on_container_copy_assignment;
+        using propagate_on_container_move_assignment = typename m_traits::propagate_on_container_move_assignment;
+        using propagate_on_container_swap = typename m_traits::propagate_on_container_swap;
+        using is_always_equal = typename m_traits::is_always_equal;
+
+        template <typename U>
+        struct rebind {
+            using other = counting_allocator<U, typename m_traits::template rebind_alloc<U>, Tag>;
+        };
+
+        counting_allocator() = default;
+
+        explicit counting_allocator(Upstream const& upstream) noexcept : Upstream(upstream) {}
+
+        template <typename U, typename UUpstream>
+        counting_allocator(counting_allocator<U, UUpstream, Tag> const& other) noexcept
+            : Upstream(other.get_upstream()) {}
+
+        static auto stats() noexcept -> allocation_stats {
+            return m_stats.snapshot();
+        }
+
+        static void reset_stats() noexcept {
+            m_stats.reset();
+        }
+
+        auto get_upstream() const noexcept -> Upstream const& {
+            return *this;
+        }
+
+        auto allocate(size_type n) -> pointer {
+            auto ptr = m_traits::allocate(upstream(), n);
+            m_stats.allocated(n * sizeof(T));
+            return ptr;
+        }
+
+        void deallocate(pointer ptr, size_type n) noexcept {
+            m_stats.deallocated(n * sizeof(T));
+            m_traits::deallocate(upstream(), ptr, n);
+        }
+
+        template <typename U, typename... Args>
+        void construct(U* ptr, Args&&... args) {
+            m_traits::construct(upstream(), ptr, std::forward<Args>(args)...);
+            m_stats.constructed();
+        }
+
+        template <typename U>
+        void destroy(U* ptr) noexcept {
+            m_stats.destroyed();
+            m_traits::destroy(upstream(), ptr);
+        }
+
+        auto select_on_container_copy_construction() const -> counting_allocator {
+            return counting_allocator(m_traits::select_on_container_copy_construction(get_upstream()));
+        }
+
+        template <typename U, typename UUpstream>
+        friend auto operator==(counting_allocator const& a, counting_allocator<U, UUpstream, Tag> const& b) noexcept
+            -> bool {
+            return a.get_upstream() == b.get_upstream();
+        }
+
+        template <typename U, typename UUpstream>
+        friend auto operator!=(counting_allocator const& a, counting_allocator<U, UUpstream, Tag> const& b) noexcept
+            -> bool {
+            return !(a == b);
+        }
+    };
+}
+
+#endif // BEN_COUNTING_ALLOCATOR_HPP
@@ -0,0 +1,422 @@
+#ifndef BEN_COW_BOX_HPP
+#define BEN_COW_BOX_HPP
+
+#include "box.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace ben {
+
+    // Reference counting policies for cow_box.
+    //
+    // Plain counter, for boxes whose copies never leave the thread they were made on.
+    struct nonatomic_refcount {
+        class counter {
+            private:
+            std::size_t m_count = 1;
+
+            public:
+            void increment() noexcept {
+                ++m_count;
+            }
+
+            // Returns whether the last reference was dropped.
+            auto decrement() noexcept -> bool {
+                return --m_count == 0;
+            }
+
+            auto count() const noexcept -> std::size_t {
+                return m_count;
+            }
+        };
+    };
+
+    // Atomic counter, so that copies sharing an element can be handed to and dropped on other threads. As with
+    // `std::shared_ptr`, a single box must still not be used by multiple threads at once.
+    struct atomic_refcount {
+        class counter {
+            private:
+            std::atomic<std::size_t> m_count{1};
+
+            public:
+            void increment() noexcept {
+                m_count.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            auto decrement() noexcept -> bool {
+                return m_count.fetch_sub(1, std::memory_order_acq_rel) == 1;
+            }
+
+            auto count() const noexcept -> std::size_t {
+                return m_count.load(std::memory_order_acquire);
+            }
+        };
+    };
+
+    namespace detail {
+        // The reference count lives in the same allocation as the element.
+        template <typename T, typename Counter>
+        struct cow_block {
+            Counter refs;
+            alignas(T) unsigned char storage[sizeof(T)];
+
+            auto value() noexcept -> T* {
+                return std::launder(reinterpret_cast<T*>(storage));
+            }
+        };
+    }
+
+    template <typename T, typename Refcount = atomic_refcount, typename Allocator = std::allocator<T>>
+    class cow_box;
+
+    template <typename T, typename Refcount, typename Allocator>
+    void swap(cow_box<T, Refcount, Allocator>& a, cow_box<T, Refcount, Allocator>& b) noexcept;
+
+    // A copy-on-write box: copies share the element and only increment a reference count, so copying is O(1).
+    // Mutable access to an element that is shared first clones it, so that the change is not observed by the
+    // copies that exist at that time. Read-only access through a const box never clones.
+    //
+    // Copies made later share the element again, also with references, pointers and iterators obtained through
+    // mutable access before; writing through those changes every copy. Drop them before copying the box, or copy
+    // the element instead.
+    //
+    // Since storage may be shared, erasing a cow_box drops its reference instead of keeping the storage around.
+    // Copies only share if their allocators compare equal; otherwise the element is copied as it is by box.
+    template <typename T, typename Refcount, typename Allocator>
+    class cow_box {
+        private:
+        using m_traits = std::allocator_traits<Allocator>;
+        using m_block_type = detail::cow_block<T, typename Refcount::counter>;
+        using m_block_allocator = typename m_traits::template rebind_alloc<m_block_type>;
+        using m_block_traits = std::allocator_traits<m_block_allocator>;
+
+        static_assert(std::is_same_v<typename m_block_traits::pointer, m_block_type*>,
+            "cow_box requires an allocator with raw pointers");
+
+        public:
+        using value_type = T;
+        using allocator_type = Allocator;
+        using size_type = typename m_traits::size_type;
+        using difference_type = typename m_traits::difference_type;
+        using reference = T&;
+        using const_reference = T const&;
+        using pointer = T*;
+        using const_pointer = T const*;
+        using iterator = T*;
+        using const_iterator = T const*;
+
+        private:
+        detail::compressed_pair<allocator_type, m_block_type*> m_storage;
+
+        auto m_alloc() noexcept -> allocator_type& {
+            return m_storage.first();
+        }
+
+        auto m_alloc() const noexcept -> allocator_type const& {
+            return m_storage.first();
+        }
+
+        auto m_block() noexcept -> m_block_type*& {
+            return m_storage.second();
+        }
+
+        auto m_block() const noexcept -> m_block_type* {
+            return m_storage.second();
+        }
+
+        template <typename... Args>
+        auto make_block(Args&&... args) -> m_block_type* {
+            auto block_alloc = m_block_allocator(m_alloc());
+            auto block = new (m_block_traits::allocate(block_alloc, 1)) m_block_type;
+
+            try {
+                m_traits::construct(m_alloc(), reinterpret_cast<T*>(block->storage), std::forward<Args>(args)...);
+            } catch (...) {
+                block->~m_block_type();
+                m_block_traits::deallocate(block_alloc, block, 1);
+                throw;
+            }
+
+            return block;
+        }
+
+        void destroy_block(m_block_type* block) noexcept {
+            auto block_alloc = m_block_allocator(m_alloc());
+
+            m_traits::destroy(m_alloc(), block->value());
+            block->~m_block_type();
+            m_block_traits::deallocate(block_alloc, block, 1);
+        }
+
+        void release() noexcept {
+            if (m_block() != nullptr) {
+                if (m_block()->refs.decrement()) {
+                    destroy_block(m_block());
+                }
+
+                m_block() = nullptr;
+            }
+        }
+
+        // Shares the element of `other`, whose allocator must be equal to ours.
+        void share(cow_box const& other) noexcept {
+            if (other.m_block() != nullptr) {
+                other.m_block()->refs.increment();
+            }
+
+            release();
+            m_block() = other.m_block();
+        }
+
+        void clone_from(cow_box const& other) {
+            if (other.has_value()) {
+                replace_value(other.value());
+            } else {
+                erase();
+            }
+        }
+
+        // Replaces the element of a block this box owns alone. If the constructor throws, the block is freed and
+        // the box is left empty.
+        template <typename... Args>
+        void reconstruct_value(Args&&... args) {
+            auto block = m_block();
+            m_traits::destroy(m_alloc(), block->value());
+
+            try {
+                m_traits::construct(m_alloc(), block->value(), std::forward<Args>(args)...);
+            } catch (...) {
+                auto block_alloc = m_block_allocator(m_alloc());
+
+                block->~m_block_type();
+                m_block_traits::deallocate(block_alloc, block, 1);
+                m_block() = nullptr;
+                throw;
+            }
+        }
+
+        // A shared element is left to its other owners and replaced by a new one. An element that is not shared is
+        // replaced in place, just like `adaptive_emplace` does for box.
+        template <typename... Args>
+        void replace_value(Args&&... args) {
+            if (has_value() && m_block()->refs.count() == 1) {
+                if constexpr (detail::reconstructs<adaptive_emplace, T, Args...>
+                              && detail::copies_arguments<adaptive_emplace, T, Args...>) {
+                    reconstruct_value(std::decay_t<Args>(args)...);
+                } else if constexpr (detail::reconstructs<adaptive_emplace, T, Args...>) {
+                    reconstruct_value(std::forward<Args>(args)...);
+                } else if constexpr (detail::is_direct_assignment<T, Args...>) {
+                    *m_block()->value() = (std::forward<Args>(args), ...);
+                } else {
+                    *m_block()->value() = value_type(std::forward<Args>(args)...);
+                }
+
+                return;
+            }
+
+            auto block = make_block(std::forward<Args>(args)...);
+            release();
+            m_block() = block;
+        }
+
+        // Makes sure the element is not shared before handing out mutable access to it.
+        void detach() {
+            if (m_block() != nullptr && m_block()->refs.count() != 1) {
+                auto block = make_block(std::as_const(*m_block()->value()));
+                release();
+                m_block() = block;
+            }
+        }
+
+        friend void swap<T, Refcount, Allocator>(cow_box<T, Refcount, Allocator>& a,
+                                                 cow_box<T, Refcount, Allocator>& b) noexcept;
+
+        public:
+        cow_box() noexcept(noexcept(Allocator())) : m_storage(Allocator(), nullptr) {}
+        explicit cow_box(allocator_type const& alloc) noexcept : m_storage(alloc, nullptr) {}
+
+        explicit cow_box(T const& element, allocator_type const& alloc = Allocator()) : m_storage(alloc, nullptr) {
+            m_block() = make_block(element);
+        }
+
+        explicit cow_box(T&& element, allocator_type const& alloc = Allocator()) : m_storage(alloc, nullptr) {
+            m_block() = make_block(std::move(element));
+        }
+
+        cow_box(cow_box const& other)
+            : m_storage(m_traits::select_on_container_copy_construction(other.m_alloc()), nullptr) {
+
+            if (m_traits::is_always_equal::value || m_alloc() == other.m_alloc()) {
+                share(other);
+            } else {
+                clone_from(other);
+            }
+        }
+
+        cow_box(cow_box&& other) noexcept : m_storage(std::move(other.m_alloc()), other.m_block()) {
+            other.m_block() = nullptr;
+        }
+
+        ~cow_box() {
+            release();
+        }
+
+        auto operator=(cow_box const& other) -> cow_box& {
+            if (this == &other) {
+                return *this;
+            }
+
+            if constexpr (m_traits::propagate_on_container_copy_assignment::value) {
+                if (m_alloc() != other.m_alloc()) {
+                    release();
+                }
+
+                m_alloc() = other.m_alloc();
+            }
+
+            if (m_traits::is_always_equal::value || m_alloc() == other.m_alloc()) {
+                share(other);
+            } else {
+                clone_from(other);
+            }
+
+            return *this;
+        }
+
+        auto operator=(cow_box&& other) noexcept(m_traits::propagate_on_container_move_assignment::value
+                                                 || m_traits::is_always_equal::value) -> cow_box& {
+            if (this == &other) {
+                return *this;
+            }
+
+            if (m_traits::is_always_equal::value || m_alloc() == other.m_alloc()) {
+                release();
+                m_block() = std::exchange(other.m_block(), nullptr);
+            } else if constexpr (m_traits::propagate_on_container_move_assignment::value) {
+                release();
+                m_block() = std::exchange(other.m_block(), nullptr);
+                m_alloc() = std::move(other.m_alloc());
+            } else {
+                clone_from(other);
+                other.erase();
+            }
+
+            return *this;
+        }
+
+        auto get_allocator() const noexcept -> allocator_type {
+            return m_alloc();
+        }
+
+        // Clones the element if it is shared. The reference must not be used to write once the box was copied.
+        auto value() -> reference {
+            detach();
+            return *m_block()->value();
+        }
+
+        auto value() const noexcept -> const_reference {
+            return *m_block()->value();
+        }
+
+        auto operator*() -> reference {
+            return value();
+        }
+
+        auto operator*() const noexcept -> const_reference {
+            return value();
+        }
+
+        auto safe_value() -> std::optional<std::reference_wrapper<value_type>> {
+            if (has_value()) {
+                return value();
+            }
+
+            return std::nullopt;
+        }
+
+        auto safe_value() const noexcept -> std::optional<std::reference_wrapper<value_type const>> {
+            if (has_value()) {
+                return value();
+            }
+
+            return std::nullopt;
+        }
+
+        auto has_value() const noexcept -> bool {
+            return m_block() != nullptr;
+        }
+
+        auto size() const noexcept -> size_type {
+            return has_value() ? 1 : 0;
+        }
+
+        // The number of boxes sharing the element, or 0 if there is none.
+        auto use_count() const noexcept -> std::size_t {
+            return has_value() ? m_block()->refs.count() : 0;
+        }
+
+        template <typename... Args>
+        void emplace(Args&&... args) {
+            replace_value(std::forward<Args>(args)...);
+        }
+
+        void push(T const& val) {
+            replace_value(val);
+        }
+
+        void push(T&& val) {
+            replace_value(std::move(val));
+        }
+
+        void erase() noexcept {
+            release();
+        }
+
+        auto begin() -> iterator {
+            return has_value() ? &value() : nullptr;
+        }
+
+        auto begin() const noexcept -> const_iterator {
+            return has_value() ? m_block()->value() : nullptr;
+        }
+
+        auto end() -> iterator {
+            return has_value() ? &value() + 1 : nullptr;
+        }
+
+        auto end() const noexcept -> const_iterator {
+            return has_value() ? m_block()->value() + 1 : nullptr;
+        }
+
+        auto cbegin() const noexcept -> const_iterator {
+            return begin();
+        }
+
+        auto cend() const noexcept -> const_iterator {
+            return end();
+        }
+    };
+
+    template <typename T, typename Refcount, typename Allocator>
+    void swap(cow_box<T, Refcount, Allocator>& a, cow_box<T, Refcount, Allocator>& b) noexcept {
+        using std::swap;
+
+        if constexpr (std::allocator_traits<Allocator>::propagate_on_container_swap::value) {
+            swap(a.m_alloc(), b.m_alloc());
+        }
+
+        swap(a.m_block(), b.m_block());
+    }
+
+    template <typename T, typename Refcount, typename Allocator>
+    struct is_trivially_relocatable<cow_box<T, Refcount, Allocator>> : is_trivially_relocatable<Allocator> {};
+}
+
+#endif // BEN_COW_BOX_HPP
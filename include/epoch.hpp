@@ -0,0 +1,389 @@
+#ifndef BEN_EPOCH_HPP
+#define BEN_EPOCH_HPP
+
+#include "box.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ben {
+
+    namespace detail {
+        // Announces which epoch a thread is reading in, or 0 if it is not reading at all.
+        struct epoch_record {
+            std::atomic<std::uint64_t> epoch{0};
+            std::atomic<bool> in_use{true};
+            // Only ever touched by the thread owning the record.
+            std::size_t nesting = 0;
+            epoch_record* next = nullptr;
+        };
+
+        struct retired_object {
+            void* ptr;
+            void (*deleter)(void*) noexcept;
+            std::uint64_t epoch;
+        };
+
+        // Shared by a domain and the threads that have used it, so that neither has to outlive the other.
+        struct epoch_state {
+            std::atomic<std::uint64_t> epoch{1};
+            // Records are never removed, only handed on to the next thread once their owner exits.
+            std::atomic<epoch_record*> records{nullptr};
+
+            std::mutex retired_mutex;
+            std::vector<retired_object> retired;
+
+            epoch_state() = default;
+            epoch_state(epoch_state const&) = delete;
+            auto operator=(epoch_state const&) -> epoch_state& = delete;
+
+            ~epoch_state() {
+                auto record = records.load(std::memory_order_acquire);
+
+                while (record != nullptr) {
+                    delete std::exchange(record, record->next);
+                }
+            }
+
+            auto acquire_record() -> epoch_record* {
+                for (auto record = records.load(std::memory_order_acquire); record != nullptr;
+                     record = record->next) {
+                    auto in_use = false;
+
+                    if (record->in_use.compare_exchange_strong(in_use, true, std::memory_order_acquire)) {
+                        return record;
+                    }
+                }
+
+                auto record = new epoch_record();
+                record->next = records.load(std::memory_order_relaxed);
+
+                while (!records.compare_exchange_weak(record->next, record, std::memory_order_release,
+                                                      std::memory_order_relaxed)) {}
+
+                return record;
+            }
+
+            // The epoch may only advance once every reader has caught up with the current one.
+            auto try_advance() noexcept -> bool {
+                auto current = epoch.load(std::memory_order_seq_cst);
+
+                for (auto record = records.load(std::memory_order_acquire); record != nullptr;
+                     record = record->next) {
+                    auto announced = record->epoch.load(std::memory_order_seq_cst);
+
+                    if (announced != 0 && announced != current) {
+                        return false;
+                    }
+                }
+
+                return epoch.compare_exchange_strong(current, current + 1, std::memory_order_seq_cst);
+            }
+        };
+
+        // The records a thread has taken from each domain it used, returned when the thread exits.
+        class epoch_thread_records {
+            private:
+            struct entry {
+                std::shared_ptr<epoch_state> state;
+                epoch_record* record;
+            };
+
+            std::vector<entry> m_entries;
+
+            public:
+            epoch_thread_records() = default;
+            epoch_thread_records(epoch_thread_records const&) = delete;
+            auto operator=(epoch_thread_records const&) -> epoch_thread_records& = delete;
+
+            ~epoch_thread_records() {
+                for (auto& e : m_entries) {
+                    e.record->in_use.store(false, std::memory_order_release);
+                }
+            }
+
+            auto record_for(std::shared_ptr<epoch_state> const& state) -> epoch_record* {
+                for (auto it = m_entries.rbegin(); it != m_entries.rend(); ++it) {
+                    if (it->state == state) {
+                        return it->record;
+                    }
+                }
+
+                m_entries.push_back({state, state->acquire_record()});
+                return m_entries.back().record;
+            }
+        };
+
+        inline thread_local epoch_thread_records epoch_records;
+
+        template <typename Box>
+        void destroy_released(void* ptr) noexcept {
+            using pointer = typename Box::pointer;
+            static_cast<void>(box_access::adopt<Box>(static_cast<pointer>(ptr), typename Box::allocator_type()));
+        }
+
+        template <typename Box>
+        void delete_retired(void* ptr) noexcept {
+            delete static_cast<Box*>(ptr);
+        }
+    }
+
+    class epoch_domain;
+
+    // Keeps the calling thread inside of a read-side critical section of an epoch domain: nothing retired into
+    // the domain after the guard was created is destroyed while it is alive. Guards nest, and must be destroyed
+    // on the thread that created them.
+    class epoch_guard {
+        private:
+        detail::epoch_record* m_record;
+
+        explicit epoch_guard(detail::epoch_record* record) noexcept : m_record(record) {}
+
+        friend class epoch_domain;
+
+        public:
+        epoch_guard(epoch_guard&& other) noexcept : m_record(std::exchange(other.m_record, nullptr)) {}
+
+        epoch_guard(epoch_guard const&) = delete;
+        auto operator=(epoch_guard const&) -> epoch_guard& = delete;
+        auto operator=(epoch_guard&&) -> epoch_guard& = delete;
+
+        ~epoch_guard() {
+            if (m_record != nullptr && --m_record->nesting == 0) {
+                m_record->epoch.store(0, std::memory_order_release);
+            }
+        }
+    };
+
+    // Epoch-based reclamation: objects that readers may still be looking at are retired instead of destroyed,
+    // and only destroyed once every thread that was reading at the time has left its critical section. Readers
+    // never wait, and only have to announce the current epoch when they start reading.
+    //
+    // An object retired in epoch `e` is safe to destroy once the global epoch has reached `e + 2`, since the
+    // epoch only advances when all readers have observed the current one.
+    class epoch_domain {
+        private:
+        static constexpr std::size_t m_default_collect_threshold = 64;
+
+        std::shared_ptr<detail::epoch_state> m_state;
+        std::size_t m_collect_threshold;
+
+        // Returns the number of objects now waiting. If it throws, nothing was retired.
+        auto enqueue(void* ptr, void (*deleter)(void*) noexcept) -> std::size_t {
+            auto epoch = m_state->epoch.load(std::memory_order_seq_cst);
+            auto lock = std::lock_guard(m_state->retired_mutex);
+
+            m_state->retired.push_back({ptr, deleter, epoch});
+            return m_state->retired.size();
+        }
+
+        void collect_if_due(std::size_t pending) {
+            if (m_collect_threshold != 0 && pending >= m_collect_threshold) {
+                collect();
+            }
+        }
+
+        public:
+        // Retiring collects whenever at least `collect_threshold` objects are waiting, unless it is zero.
+        explicit epoch_domain(std::size_t collect_threshold = m_default_collect_threshold)
+            : m_state(std::make_shared<detail::epoch_state>()), m_collect_threshold(collect_threshold) {}
+
+        epoch_domain(epoch_domain const&) = delete;
+        auto operator=(epoch_domain const&) -> epoch_domain& = delete;
+
+        // No guards for the domain may be alive anymore, so everything retired can be destroyed right away.
+        ~epoch_domain() {
+            auto retired = std::vector<detail::retired_object>();
+
+            {
+                auto lock = std::lock_guard(m_state->retired_mutex);
+                retired.swap(m_state->retired);
+            }
+
+            for (auto const& object : retired) {
+                object.deleter(object.ptr);
+            }
+        }
+
+        // The domain used by default, e.g. by atomic_box.
+        static auto global() -> epoch_domain& {
+            static auto domain = epoch_domain();
+            return domain;
+        }
+
+        auto pin() -> epoch_guard {
+            auto record = detail::epoch_records.record_for(m_state);
+
+            if (record->nesting++ == 0) {
+                record->epoch.store(m_state->epoch.load(std::memory_order_seq_cst), std::memory_order_seq_cst);
+            }
+
+            return epoch_guard(record);
+        }
+
+        // Destroys `ptr` with `deleter` once no reader can be looking at it anymore. The object must already be
+        // unreachable for new readers.
+        void retire(void* ptr, void (*deleter)(void*) noexcept) {
+            collect_if_due(enqueue(ptr, deleter));
+        }
+
+        // Destroys the element of `b` in a later `collect` instead of on the calling thread, and leaves `b` without
+        // storage. Boxes with an allocator that is always equal are retired without allocating; all others are
+        // moved to the heap as a whole.
+        template <typename T, typename Allocator, typename Policy>
+        void retire(box<T, Allocator, Policy>&& b) {
+            using box_type = box<T, Allocator, Policy>;
+            using traits = std::allocator_traits<Allocator>;
+
+            if (!b.has_value()) {
+                b.reset();
+                return;
+            }
+
+            if constexpr (traits::is_always_equal::value && std::is_default_constructible_v<Allocator>
+                          && std::is_same_v<typename traits::pointer, T*>) {
+                auto ptr = b.release();
+                auto pending = std::size_t(0);
+
+                // Once enqueued, the element belongs to the domain, even if collecting throws.
+                try {
+                    pending = enqueue(ptr, &detail::destroy_released<box_type>);
+                } catch (...) {
+                    b = detail::box_access::adopt<box_type>(ptr, Allocator());
+                    throw;
+                }
+
+                collect_if_due(pending);
+            } else {
+                auto node = std::make_unique<box_type>(std::move(b));
+                auto pending = enqueue(node.get(), &detail::delete_retired<box_type>);
+                node.release();
+                collect_if_due(pending);
+            }
+        }
+
+        // The number of retired objects that have not been destroyed yet.
+        auto pending() const -> std::size_t {
+            auto lock = std::lock_guard(m_state->retired_mutex);
+            return m_state->retired.size();
+        }
+
+        // Destroys all retired objects that are safe to destroy, in one batch, and returns how many there were.
+        // Without any readers, that is everything retired before the call. If it throws, everything is still
+        // retired.
+        auto collect() -> std::size_t {
+            if (m_state->try_advance()) {
+                m_state->try_advance();
+            }
+
+            auto current = m_state->epoch.load(std::memory_order_seq_cst);
+            auto ready = std::vector<detail::retired_object>();
+
+            {
+                auto lock = std::lock_guard(m_state->retired_mutex);
+                auto& retired = m_state->retired;
+                auto kept = retired.begin();
+
+                // So that nothing below can throw while entries are being moved around.
+                ready.reserve(retired.size());
+
+                for (auto it = retired.begin(); it != retired.end(); ++it) {
+                    if (it->epoch + 2 <= current) {
+                        ready.push_back(*it);
+                    } else {
+                        *kept++ = *it;
+                    }
+                }
+
+                retired.erase(kept, retired.end());
+            }
+
+            for (auto const& object : ready) {
+                object.deleter(object.ptr);
+            }
+
+            return ready.size();
+        }
+
+        // Waits until every reader that might have seen an object unlinked before the call has finished. Must not
+        // be called while the calling thread holds a guard for this domain.
+        void synchronize() {
+            auto target = m_state->epoch.load(std::memory_order_seq_cst) + 2;
+
+            while (m_state->epoch.load(std::memory_order_seq_cst) < target) {
+                if (!m_state->try_advance()) {
+                    std::this_thread::yield();
+                }
+            }
+        }
+    };
+
+    // Collects an epoch domain on a thread of its own, so that retired objects are never destroyed on the threads
+    // that retire them. Pair it with a domain whose collect threshold is zero. Whatever is still pending when the
+    // reclaimer stops is left to the domain.
+    class background_reclaimer {
+        private:
+        epoch_domain* m_domain;
+        std::chrono::microseconds m_interval;
+
+        std::mutex m_mutex;
+        std::condition_variable m_wake;
+        bool m_woken = false;
+        bool m_stopped = false;
+
+        // Last, so that the thread only starts once everything else is initialized.
+        std::thread m_thread;
+
+        void run() {
+            auto lock = std::unique_lock(m_mutex);
+
+            while (!m_stopped) {
+                lock.unlock();
+                m_domain->collect();
+                lock.lock();
+
+                m_wake.wait_for(lock, m_interval, [this] { return m_woken || m_stopped; });
+                m_woken = false;
+            }
+        }
+
+        public:
+        explicit background_reclaimer(epoch_domain& domain,
+                                      std::chrono::microseconds interval = std::chrono::milliseconds(1))
+            : m_domain(&domain), m_interval(interval), m_thread([this] { run(); }) {}
+
+        background_reclaimer(background_reclaimer const&) = delete;
+        auto operator=(background_reclaimer const&) -> background_reclaimer& = delete;
+
+        ~background_reclaimer() {
+            {
+                auto lock = std::lock_guard(m_mutex);
+                m_stopped = true;
+            }
+
+            m_wake.notify_one();
+            m_thread.join();
+        }
+
+        // Collects right away instead of waiting for the interval to pass.
+        void wake() {
+            {
+                auto lock = std::lock_guard(m_mutex);
+                m_woken = true;
+            }
+
+            m_wake.notify_one();
+        }
+    };
+}
+
+#endif // BEN_EPOCH_HPP
@@ -0,0 +1,238 @@
+#ifndef BEN_HASHED_BOX_HPP
+#define BEN_HASHED_BOX_HPP
+
+#include "box.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace ben {
+
+    // A box that keeps the hash of its element next to the pointer. Hashing a hashed_box only reads that hash, and
+    // comparing two of them compares their hashes before looking at the elements, so that probing a hash table
+    // keyed by hashed_boxes rarely dereferences anything.
+    //
+    // To keep the hash up to date, the element can only be changed through the members below: `emplace`, `push`,
+    // `erase`, `reset`, and `modify`, which rehashes after handing the element to a function.
+    template <typename T, typename Hash = std::hash<T>, typename Allocator = std::allocator<T>,
+              typename Policy = default_box_policy>
+    class hashed_box {
+        public:
+        using box_type = box<T, Allocator, Policy>;
+        using value_type = T;
+        using allocator_type = Allocator;
+        using hasher = Hash;
+        using size_type = typename box_type::size_type;
+        using const_reference = typename box_type::const_reference;
+        using const_iterator = typename box_type::const_iterator;
+
+        private:
+        detail::compressed_pair<Hash, box_type> m_storage;
+        std::size_t m_hash = detail::empty_box_hash;
+
+        auto m_box() noexcept -> box_type& {
+            return m_storage.second();
+        }
+
+        auto m_box() const noexcept -> box_type const& {
+            return m_storage.second();
+        }
+
+        // If the hasher throws, the element is erased, so that the hash never goes stale.
+        void rehash() {
+            try {
+                m_hash = m_box().has_value() ? m_storage.first()(m_box().value()) : detail::empty_box_hash;
+            } catch (...) {
+                erase();
+                throw;
+            }
+        }
+
+        // For when an exception is already on its way, or none may leave.
+        void rehash_or_erase() noexcept {
+            try {
+                rehash();
+            } catch (...) {}
+        }
+
+        // Runs `change`, which may replace or modify the element, and rehashes afterwards, even if it throws.
+        template <typename Change>
+        auto changing(Change&& change) -> std::invoke_result_t<Change&> {
+            using result_type = std::invoke_result_t<Change&>;
+
+            try {
+                if constexpr (std::is_void_v<result_type>) {
+                    change();
+                    rehash();
+                } else {
+                    auto&& result = change();
+                    rehash();
+                    return std::forward<result_type>(result);
+                }
+            } catch (...) {
+                rehash_or_erase();
+                throw;
+            }
+        }
+
+        public:
+        hashed_box() = default;
+
+        explicit hashed_box(allocator_type const& alloc, Hash const& hash = Hash())
+            : m_storage(hash, box_type(alloc)) {}
+
+        explicit hashed_box(T const& element, allocator_type const& alloc = Allocator(), Hash const& hash = Hash())
+            : m_storage(hash, box_type(element, alloc)) {
+            rehash();
+        }
+
+        explicit hashed_box(T&& element, allocator_type const& alloc = Allocator(), Hash const& hash = Hash())
+            : m_storage(hash, box_type(std::move(element), alloc)) {
+            rehash();
+        }
+
+        explicit hashed_box(box_type&& b, Hash const& hash = Hash()) : m_storage(hash, std::move(b)) {
+            rehash();
+        }
+
+        hashed_box(hashed_box const&) = default;
+
+        hashed_box(hashed_box&& other) noexcept
+            : m_storage(std::move(other.m_storage)), m_hash(std::exchange(other.m_hash, detail::empty_box_hash)) {}
+
+        auto operator=(hashed_box const&) -> hashed_box& = default;
+
+        auto operator=(hashed_box&& other) noexcept(std::is_nothrow_move_assignable_v<box_type>) -> hashed_box& {
+            m_storage.first() = std::move(other.m_storage.first());
+            m_box() = std::move(other.m_box());
+            m_hash = other.m_hash;
+            // Unless the allocator moved along, the element was moved over instead and the other box keeps it.
+            other.rehash_or_erase();
+            return *this;
+        }
+
+        auto get_allocator() const noexcept -> allocator_type {
+            return m_box().get_allocator();
+        }
+
+        auto hash_function() const -> hasher {
+            return m_storage.first();
+        }
+
+        // The hash of the element, or the same fixed value for every empty box.
+        auto hash() const noexcept -> std::size_t {
+            return m_hash;
+        }
+
+        auto get_box() const noexcept -> box_type const& {
+            return m_box();
+        }
+
+        // Takes the box out, leaving this one empty.
+        auto take_box() noexcept -> box_type {
+            auto b = std::move(m_box());
+            m_hash = detail::empty_box_hash;
+            return b;
+        }
+
+        auto value() const noexcept -> const_reference {
+            return m_box().value();
+        }
+
+        auto operator*() const noexcept -> const_reference {
+            return m_box().value();
+        }
+
+        auto has_value() const noexcept -> bool {
+            return m_box().has_value();
+        }
+
+        auto size() const noexcept -> size_type {
+            return m_box().size();
+        }
+
+        template <typename... Args>
+        void emplace(Args&&... args) {
+            changing([&] { m_box().emplace(std::forward<Args>(args)...); });
+        }
+
+        void push(T const& val) {
+            changing([&] { m_box().push(val); });
+        }
+
+        void push(T&& val) {
+            changing([&] { m_box().push(std::move(val)); });
+        }
+
+        void erase() noexcept {
+            m_box().erase();
+            m_hash = detail::empty_box_hash;
+        }
+
+        void reset() noexcept {
+            m_box().reset();
+            m_hash = detail::empty_box_hash;
+        }
+
+        // Calls `fn` with the element, which it may change, and rehashes the element afterwards, also if `fn`
+        // throws. The box must hold an element. If the hasher throws, the element is erased.
+        template <typename Fn>
+        decltype(auto) modify(Fn&& fn) {
+            return changing([&]() -> decltype(auto) { return std::forward<Fn>(fn)(m_box().value()); });
+        }
+
+        auto begin() const noexcept -> const_iterator {
+            return m_box().begin();
+        }
+
+        auto end() const noexcept -> const_iterator {
+            return m_box().end();
+        }
+
+        friend auto operator==(hashed_box const& a, hashed_box const& b) -> bool {
+            return a.m_hash == b.m_hash && a.m_box() == b.m_box();
+        }
+
+        friend auto operator!=(hashed_box const& a, hashed_box const& b) -> bool {
+            return !(a == b);
+        }
+
+        friend auto operator<(hashed_box const& a, hashed_box const& b) -> bool {
+            return a.m_box() < b.m_box();
+        }
+
+        friend auto operator>(hashed_box const& a, hashed_box const& b) -> bool {
+            return b < a;
+        }
+
+        friend auto operator<=(hashed_box const& a, hashed_box const& b) -> bool {
+            return !(b < a);
+        }
+
+        friend auto operator>=(hashed_box const& a, hashed_box const& b) -> bool {
+            return !(a < b);
+        }
+
+        friend void swap(hashed_box& a, hashed_box& b) noexcept {
+            using std::swap;
+            swap(a.m_storage.first(), b.m_storage.first());
+            swap(a.m_box(), b.m_box());
+            swap(a.m_hash, b.m_hash);
+        }
+    };
+}
+
+namespace std {
+    // Returns the cached hash, without touching the element.
+    template <typename T, typename Hash, typename Allocator, typename Policy>
+    struct hash<ben::hashed_box<T, Hash, Allocator, Policy>> {
+        auto operator()(ben::hashed_box<T, Hash, Allocator, Policy> const& b) const noexcept -> std::size_t {
+            return b.hash();
+        }
+    };
+}
+
+#endif // BEN_HASHED_BOX_HPP
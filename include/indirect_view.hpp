@@ -0,0 +1,143 @@
+#ifndef BEN_INDIRECT_VIEW_HPP
+#define BEN_INDIRECT_VIEW_HPP
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace ben {
+
+    namespace detail {
+        inline void prefetch(void const* address) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+            __builtin_prefetch(address);
+#else
+            static_cast<void>(address);
+#endif
+        }
+    }
+
+    // A view of the elements of a range of boxes: iterating it yields the elements themselves and skips empty
+    // boxes. While it is at one box, it asks the CPU to prefetch the element of the box `distance` boxes ahead, so
+    // that the element is already in cache when the iteration gets there. Elements allocated one by one are
+    // scattered across the heap; without prefetching, every step waits for memory.
+    //
+    // A good distance covers the memory latency with the work done per element; the default suits loops doing
+    // little work per element. A distance of zero turns prefetching off. The view refers to the range, which has to
+    // outlive it.
+    template <typename Range>
+    class indirect_view {
+        private:
+        using m_base_iterator = decltype(std::begin(std::declval<Range&>()));
+
+        Range* m_range;
+        std::size_t m_distance;
+
+        public:
+        class iterator;
+
+        static constexpr std::size_t default_distance = 8;
+
+        explicit indirect_view(Range& range, std::size_t distance = default_distance) noexcept
+            : m_range(std::addressof(range)), m_distance(distance) {}
+
+        auto begin() const -> iterator {
+            return iterator(std::begin(*m_range), std::end(*m_range), m_distance);
+        }
+
+        auto end() const -> iterator {
+            return iterator(std::end(*m_range), std::end(*m_range), 0);
+        }
+
+        auto distance() const noexcept -> std::size_t {
+            return m_distance;
+        }
+    };
+
+    template <typename Range>
+    class indirect_view<Range>::iterator {
+        private:
+        using m_box_reference = decltype(*std::declval<m_base_iterator&>());
+
+        // Runs `distance` boxes ahead of `m_current`, or sits at the end.
+        m_base_iterator m_current;
+        m_base_iterator m_ahead;
+        m_base_iterator m_end;
+
+        void advance_ahead() {
+            if (m_ahead != m_end) {
+                if (m_ahead->has_value()) {
+                    detail::prefetch(std::addressof(m_ahead->value()));
+                }
+
+                ++m_ahead;
+            }
+        }
+
+        // The ahead iterator moves once per box, including the empty ones skipped here.
+        void skip_empty() {
+            while (m_current != m_end && !m_current->has_value()) {
+                ++m_current;
+                advance_ahead();
+            }
+        }
+
+        public:
+        using reference = decltype(std::declval<m_box_reference>().value());
+        using value_type = std::remove_cv_t<std::remove_reference_t<reference>>;
+        using pointer = std::remove_reference_t<reference>*;
+        using difference_type = std::ptrdiff_t;
+        using iterator_category = std::forward_iterator_tag;
+
+        iterator() = default;
+
+        iterator(m_base_iterator first, m_base_iterator last, std::size_t distance)
+            : m_current(first), m_ahead(distance == 0 ? last : first), m_end(last) {
+            for (auto i = std::size_t(0); i < distance && m_ahead != m_end; ++i) {
+                advance_ahead();
+            }
+
+            skip_empty();
+        }
+
+        auto operator*() const -> reference {
+            return m_current->value();
+        }
+
+        auto operator->() const -> pointer {
+            return std::addressof(m_current->value());
+        }
+
+        auto operator++() -> iterator& {
+            ++m_current;
+            advance_ahead();
+            skip_empty();
+            return *this;
+        }
+
+        auto operator++(int) -> iterator {
+            auto old = *this;
+            ++*this;
+            return old;
+        }
+
+        friend auto operator==(iterator const& a, iterator const& b) -> bool {
+            return a.m_current == b.m_current;
+        }
+
+        friend auto operator!=(iterator const& a, iterator const& b) -> bool {
+            return !(a == b);
+        }
+    };
+
+    // Views `range` through its elements, prefetching `distance` boxes ahead.
+    template <typename Range>
+    auto indirect(Range& range, std::size_t distance = indirect_view<Range>::default_distance) noexcept
+        -> indirect_view<Range> {
+        return indirect_view<Range>(range, distance);
+    }
+}
+
+#endif // BEN_INDIRECT_VIEW_HPP
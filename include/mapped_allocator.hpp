@@ -0,0 +1,447 @@
+#ifndef BEN_MAPPED_ALLOCATOR_HPP
+#define BEN_MAPPED_ALLOCATOR_HPP
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ben {
+
+    // A pointer that stores the distance to its target instead of its address, so that it stays valid when the
+    // memory holding both is mapped at another address, e.g. by another process. Copying an offset_ptr thus
+    // recomputes the distance.
+    template <typename T>
+    class offset_ptr {
+        private:
+        template <typename U>
+        friend class offset_ptr;
+
+        // An offset_ptr never points into itself, so this distance is free to stand for null.
+        static constexpr std::ptrdiff_t m_null = 1;
+
+        std::ptrdiff_t m_offset = m_null;
+
+        // The arithmetic is done on integers: subtracting the addresses of unrelated objects is undefined, and
+        // optimizers make use of that.
+        auto address() const noexcept -> std::uintptr_t {
+            return reinterpret_cast<std::uintptr_t>(this);
+        }
+
+        void set(T* ptr) noexcept {
+            m_offset = ptr == nullptr ? m_null
+                : static_cast<std::ptrdiff_t>(reinterpret_cast<std::uintptr_t>(ptr) - address());
+        }
+
+        public:
+        using element_type = T;
+        using value_type = std::remove_cv_t<T>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = T*;
+        using reference = std::conditional_t<std::is_void_v<T>, void, std::add_lvalue_reference_t<T>>;
+        using iterator_category = std::random_access_iterator_tag;
+
+        template <typename U>
+        using rebind = offset_ptr<U>;
+
+        offset_ptr() noexcept = default;
+        offset_ptr(std::nullptr_t) noexcept {}
+
+        offset_ptr(T* ptr) noexcept {
+            set(ptr);
+        }
+
+        offset_ptr(offset_ptr const& other) noexcept {
+            set(other.get());
+        }
+
+        template <typename U, typename = std::enable_if_t<std::is_convertible_v<U*, T*>>>
+        offset_ptr(offset_ptr<U> const& other) noexcept {
+            set(other.get());
+        }
+
+        // Allows `static_cast` from `offset_ptr<void>`, as required of allocator pointers.
+        template <typename U, typename = std::enable_if_t<!std::is_convertible_v<U*, T*>>,
+                  typename = decltype(static_cast<T*>(std::declval<U*>()))>
+        explicit offset_ptr(offset_ptr<U> const& other) noexcept {
+            set(static_cast<T*>(other.get()));
+        }
+
+        auto operator=(offset_ptr const& other) noexcept -> offset_ptr& {
+            set(other.get());
+            return *this;
+        }
+
+        auto get() const noexcept -> T* {
+            if (m_offset == m_null) {
+                return nullptr;
+            }
+
+            return reinterpret_cast<T*>(address() + static_cast<std::uintptr_t>(m_offset));
+        }
+
+        explicit operator bool() const noexcept {
+            return m_offset != m_null;
+        }
+
+        auto operator->() const noexcept -> T* {
+            return get();
+        }
+
+        template <typename U = T, typename = std::enable_if_t<!std::is_void_v<U>>>
+        auto operator*() const noexcept -> U& {
+            return *get();
+        }
+
+        template <typename U = T, typename = std::enable_if_t<!std::is_void_v<U>>>
+        auto operator[](difference_type n) const noexcept -> U& {
+            return get()[n];
+        }
+
+        template <typename U = T, typename = std::enable_if_t<!std::is_void_v<U>>>
+        static auto pointer_to(U& ref) noexcept -> offset_ptr {
+            return offset_ptr(std::addressof(ref));
+        }
+
+        auto operator+=(difference_type n) noexcept -> offset_ptr& {
+            m_offset += n * static_cast<difference_type>(sizeof(T));
+            return *this;
+        }
+
+        auto operator-=(difference_type n) noexcept -> offset_ptr& {
+            m_offset -= n * static_cast<difference_type>(sizeof(T));
+            return *this;
+        }
+
+        auto operator++() noexcept -> offset_ptr& {
+            return *this += 1;
+        }
+
+        auto operator++(int) noexcept -> offset_ptr {
+            auto old = *this;
+            ++*this;
+            return old;
+        }
+
+        auto operator--() noexcept -> offset_ptr& {
+            return *this -= 1;
+        }
+
+        auto operator--(int) noexcept -> offset_ptr {
+            auto old = *this;
+            --*this;
+            return old;
+        }
+
+        friend auto operator+(offset_ptr const& ptr, difference_type n) noexcept -> offset_ptr {
+            return offset_ptr(ptr.get() + n);
+        }
+
+        friend auto operator+(difference_type n, offset_ptr const& ptr) noexcept -> offset_ptr {
+            return offset_ptr(ptr.get() + n);
+        }
+
+        friend auto operator-(offset_ptr const& ptr, difference_type n) noexcept -> offset_ptr {
+            return offset_ptr(ptr.get() - n);
+        }
+
+        friend auto operator-(offset_ptr const& a, offset_ptr const& b) noexcept -> difference_type {
+            return a.get() - b.get();
+        }
+
+        friend auto operator==(offset_ptr const& a, offset_ptr const& b) noexcept -> bool {
+            return a.get() == b.get();
+        }
+
+        friend auto operator!=(offset_ptr const& a, offset_ptr const& b) noexcept -> bool {
+            return a.get() != b.get();
+        }
+
+        friend auto operator<(offset_ptr const& a, offset_ptr const& b) noexcept -> bool {
+            return a.get() < b.get();
+        }
+
+        friend auto operator>(offset_ptr const& a, offset_ptr const& b) noexcept -> bool {
+            return a.get() > b.get();
+        }
+
+        friend auto operator<=(offset_ptr const& a, offset_ptr const& b) noexcept -> bool {
+            return a.get() <= b.get();
+        }
+
+        friend auto operator>=(offset_ptr const& a, offset_ptr const& b) noexcept -> bool {
+            return a.get() >= b.get();
+        }
+
+        friend auto operator==(offset_ptr const& a, std::nullptr_t) noexcept -> bool {
+            return !a;
+        }
+
+        friend auto operator==(std::nullptr_t, offset_ptr const& a) noexcept -> bool {
+            return !a;
+        }
+
+        friend auto operator!=(offset_ptr const& a, std::nullptr_t) noexcept -> bool {
+            return static_cast<bool>(a);
+        }
+
+        friend auto operator!=(std::nullptr_t, offset_ptr const& a) noexcept -> bool {
+            return static_cast<bool>(a);
+        }
+    };
+
+    namespace detail {
+        // Sits at the start of every mapped region. All of its state is position independent, and the allocation
+        // counter is atomic, so that processes can allocate from the same region concurrently.
+        struct mapped_header {
+            static constexpr std::uint64_t magic_number = 0x62656e2d626f7801;
+
+            std::uint64_t magic;
+            std::size_t size;
+            std::atomic<std::size_t> used;
+            offset_ptr<void> root;
+
+            explicit mapped_header(std::size_t size) noexcept
+                : magic(magic_number), size(size), used(sizeof(mapped_header)) {}
+
+            auto allocate(std::size_t bytes, std::size_t alignment) -> void* {
+                auto base = reinterpret_cast<std::uintptr_t>(this);
+                auto used_now = used.load(std::memory_order_relaxed);
+                auto start = std::size_t(0);
+
+                do {
+                    start = (base + used_now + alignment - 1) / alignment * alignment - base;
+
+                    if (start + bytes > size) {
+                        throw std::bad_alloc();
+                    }
+                } while (!used.compare_exchange_weak(used_now, start + bytes, std::memory_order_relaxed));
+
+                return reinterpret_cast<void*>(base + start);
+            }
+        };
+
+        static_assert(std::atomic<std::size_t>::is_always_lock_free,
+            "mapped regions need address-free atomics to be shared between processes");
+    }
+
+    // A file or POSIX shared memory object mapped into memory, from which `mapped_allocator` allocates. Other
+    // processes may map the same region at another address; everything in it has to refer to other objects in it
+    // through `offset_ptr`s. The region has a root pointer through which they find the first object.
+    //
+    // Memory is handed out by bumping a counter and never reused, like with `arena`. It lives as long as the
+    // file or shared memory object.
+    class mapped_region {
+        private:
+        void* m_base = nullptr;
+        std::size_t m_size = 0;
+
+        mapped_region(void* base, std::size_t size) noexcept : m_base(base), m_size(size) {}
+
+        [[noreturn]] static void fail(char const* what) {
+            throw std::system_error(errno, std::generic_category(), what);
+        }
+
+        static auto map(int fd, std::size_t size) -> void* {
+            auto base = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            auto error = errno;
+            ::close(fd);
+
+            if (base == MAP_FAILED) {
+                errno = error;
+                fail("mmap");
+            }
+
+            return base;
+        }
+
+        static auto create(int fd, std::size_t size) -> mapped_region {
+            if (fd == -1) {
+                fail("open");
+            }
+
+            if (size < sizeof(detail::mapped_header) || ::ftruncate(fd, static_cast<off_t>(size)) == -1) {
+                auto error = size < sizeof(detail::mapped_header) ? EINVAL : errno;
+                ::close(fd);
+                errno = error;
+                fail("ftruncate");
+            }
+
+            auto base = map(fd, size);
+            new (base) detail::mapped_header(size);
+            return mapped_region(base, size);
+        }
+
+        static auto open(int fd) -> mapped_region {
+            if (fd == -1) {
+                fail("open");
+            }
+
+            struct stat info;
+
+            if (::fstat(fd, &info) == -1) {
+                auto error = errno;
+                ::close(fd);
+                errno = error;
+                fail("fstat");
+            }
+
+            auto size = static_cast<std::size_t>(info.st_size);
+            auto region = mapped_region(map(fd, size), size);
+
+            if (size < sizeof(detail::mapped_header)
+                || region.header()->magic != detail::mapped_header::magic_number) {
+                throw std::runtime_error("not a mapped region");
+            }
+
+            return region;
+        }
+
+        public:
+        // Creates the file, replacing its old contents, and maps it.
+        static auto create_file(std::string const& path, std::size_t size) -> mapped_region {
+            return create(::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600), size);
+        }
+
+        static auto open_file(std::string const& path) -> mapped_region {
+            return open(::open(path.c_str(), O_RDWR));
+        }
+
+        // `name` has to start with a slash, see `shm_open`.
+        static auto create_shared_memory(std::string const& name, std::size_t size) -> mapped_region {
+            return create(::shm_open(name.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600), size);
+        }
+
+        static auto open_shared_memory(std::string const& name) -> mapped_region {
+            return open(::shm_open(name.c_str(), O_RDWR, 0600));
+        }
+
+        static void remove_shared_memory(std::string const& name) noexcept {
+            ::shm_unlink(name.c_str());
+        }
+
+        mapped_region(mapped_region&& other) noexcept
+            : m_base(std::exchange(other.m_base, nullptr)), m_size(std::exchange(other.m_size, 0)) {}
+
+        auto operator=(mapped_region&& other) noexcept -> mapped_region& {
+            std::swap(m_base, other.m_base);
+            std::swap(m_size, other.m_size);
+            return *this;
+        }
+
+        ~mapped_region() {
+            if (m_base != nullptr) {
+                ::munmap(m_base, m_size);
+            }
+        }
+
+        auto header() const noexcept -> detail::mapped_header* {
+            return static_cast<detail::mapped_header*>(m_base);
+        }
+
+        auto base() const noexcept -> void* {
+            return m_base;
+        }
+
+        auto size() const noexcept -> std::size_t {
+            return m_size;
+        }
+
+        // The number of bytes handed out so far, including the header.
+        auto used() const noexcept -> std::size_t {
+            return header()->used.load(std::memory_order_relaxed);
+        }
+
+        auto allocate(std::size_t bytes, std::size_t alignment) -> void* {
+            return header()->allocate(bytes, alignment);
+        }
+
+        // Writes everything handed out so far back to the file and waits until it is stored. Without it, changes
+        // still reach the file eventually, but may be lost if the machine goes down.
+        void flush() const {
+            if (::msync(m_base, used(), MS_SYNC) == -1) {
+                fail("msync");
+            }
+        }
+
+        template <typename T>
+        auto root() const noexcept -> T* {
+            return static_cast<T*>(header()->root.get());
+        }
+
+        template <typename T>
+        void set_root(T* object) noexcept {
+            header()->root = static_cast<void*>(object);
+        }
+    };
+
+    // Allocates from a mapped region, using `offset_ptr`s so that boxes and their elements can live in the region
+    // and be used by every process that maps it. Like `arena_allocator`, deallocation does nothing and the
+    // allocator propagates with its elements.
+    template <typename T>
+    class mapped_allocator {
+        private:
+        template <typename U>
+        friend class mapped_allocator;
+
+        offset_ptr<detail::mapped_header> m_header;
+
+        template <typename U>
+        auto shares_with(mapped_allocator<U> const& other) const noexcept -> bool {
+            return m_header == other.m_header;
+        }
+
+        public:
+        using value_type = T;
+        using pointer = offset_ptr<T>;
+        using const_pointer = offset_ptr<T const>;
+        using void_pointer = offset_ptr<void>;
+        using const_void_pointer = offset_ptr<void const>;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using propagate_on_container_copy_assignment = std::true_type;
+        using propagate_on_container_move_assignment = std::true_type;
+        using propagate_on_container_swap = std::true_type;
+        using releases_in_bulk = std::true_type;
+
+        template <typename U>
+        struct rebind {
+            using other = mapped_allocator<U>;
+        };
+
+        mapped_allocator(mapped_region& region) noexcept : m_header(region.header()) {}
+
+        template <typename U>
+        mapped_allocator(mapped_allocator<U> const& other) noexcept : m_header(other.m_header) {}
+
+        auto allocate(size_type n) -> pointer {
+            return pointer(static_cast<T*>(m_header->allocate(n * sizeof(T), alignof(T))));
+        }
+
+        void deallocate(pointer, size_type) noexcept {}
+
+        template <typename U>
+        friend auto operator==(mapped_allocator const& a, mapped_allocator<U> const& b) noexcept -> bool {
+            return a.shares_with(b);
+        }
+
+        template <typename U>
+        friend auto operator!=(mapped_allocator const& a, mapped_allocator<U> const& b) noexcept -> bool {
+            return !(a == b);
+        }
+    };
+}
+
+#endif // BEN_MAPPED_ALLOCATOR_HPP
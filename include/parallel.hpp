@@ -0,0 +1,120 @@
+#ifndef BEN_PARALLEL_HPP
+#define BEN_PARALLEL_HPP
+
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <thread>
+#include <vector>
+
+namespace ben {
+
+    namespace detail {
+        // Below this many elements per thread, starting a thread costs more than it saves.
+        inline constexpr std::size_t parallel_min_chunk = 4096;
+
+        // Splits [0, count) into one chunk per thread and calls `fn(begin, end)` for each, the last chunk on the
+        // calling thread. Rethrows the first exception thrown by any chunk once all of them are done.
+        template <typename Fn>
+        void parallel_chunks(std::size_t count, std::size_t threads, Fn const& fn) {
+            if (threads == 0) {
+                threads = std::thread::hardware_concurrency();
+            }
+
+            auto const max_threads = (count + parallel_min_chunk - 1) / parallel_min_chunk;
+            threads = threads < max_threads ? threads : max_threads;
+
+            if (threads <= 1) {
+                if (count != 0) {
+                    fn(std::size_t(0), count);
+                }
+
+                return;
+            }
+
+            auto errors = std::vector<std::exception_ptr>(threads);
+            auto workers = std::vector<std::thread>();
+            workers.reserve(threads - 1);
+
+            auto run = [&](std::size_t index) {
+                try {
+                    fn(count * index / threads, count * (index + 1) / threads);
+                } catch (...) {
+                    errors[index] = std::current_exception();
+                }
+            };
+
+            try {
+                for (auto i = std::size_t(0); i + 1 < threads; ++i) {
+                    workers.emplace_back(run, i);
+                }
+            } catch (...) {
+                // Could not start another thread, so this one does the remaining chunks itself.
+                for (auto i = workers.size(); i + 1 < threads; ++i) {
+                    run(i);
+                }
+            }
+
+            run(threads - 1);
+
+            for (auto& worker : workers) {
+                worker.join();
+            }
+
+            for (auto const& error : errors) {
+                if (error) {
+                    std::rethrow_exception(error);
+                }
+            }
+        }
+    }
+
+    // Copy-assigns the boxes in [first, last) to the boxes starting at `d_first`, splitting the work across
+    // `threads` threads (by default, one per core). Each element is copied and allocated on the thread handling
+    // it, so pair this with an allocator that does not serialize threads on a global lock, such as
+    // `pool_allocator`. The destination boxes must already exist; empty boxes are the cheapest to assign to.
+    //
+    // If a copy throws, the exception is rethrown once all threads are done, and the destination boxes hold a mix
+    // of old and new values.
+    template <typename RandomIt, typename OutputIt>
+    auto parallel_clone(RandomIt first, RandomIt last, OutputIt d_first, std::size_t threads = 0) -> OutputIt {
+        auto const count = static_cast<std::size_t>(std::distance(first, last));
+
+        detail::parallel_chunks(count, threads, [&](std::size_t begin, std::size_t end) {
+            using difference_type = typename std::iterator_traits<RandomIt>::difference_type;
+
+            for (auto i = begin; i < end; ++i) {
+                d_first[static_cast<difference_type>(i)] = first[static_cast<difference_type>(i)];
+            }
+        });
+
+        return d_first + static_cast<typename std::iterator_traits<OutputIt>::difference_type>(count);
+    }
+
+    template <typename Range, typename OutputIt>
+    auto parallel_clone(Range const& range, OutputIt out, std::size_t threads = 0) -> OutputIt {
+        return parallel_clone(std::begin(range), std::end(range), out, threads);
+    }
+
+    // Destroys the elements of the boxes in [first, last) and gives back their storage, splitting the work across
+    // `threads` threads. The boxes are left empty, so that destroying them afterwards is cheap.
+    template <typename RandomIt>
+    void parallel_destroy(RandomIt first, RandomIt last, std::size_t threads = 0) {
+        auto const count = static_cast<std::size_t>(std::distance(first, last));
+
+        detail::parallel_chunks(count, threads, [&](std::size_t begin, std::size_t end) {
+            using difference_type = typename std::iterator_traits<RandomIt>::difference_type;
+
+            for (auto i = begin; i < end; ++i) {
+                first[static_cast<difference_type>(i)].reset();
+            }
+        });
+    }
+
+    template <typename Range>
+    void parallel_destroy(Range& range, std::size_t threads = 0) {
+        parallel_destroy(std::begin(range), std::end(range), threads);
+    }
+}
+
+#endif // BEN_PARALLEL_HPP
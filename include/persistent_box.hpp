@@ -0,0 +1,173 @@
+#ifndef BEN_PERSISTENT_BOX_HPP
+#define BEN_PERSISTENT_BOX_HPP
+
+#include "box.hpp"
+#include "mapped_allocator.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <typeinfo>
+#include <utility>
+
+#include <unistd.h>
+
+namespace ben {
+
+    namespace detail {
+        // Identifies the element type of a persistent box well enough to catch a file being opened as the wrong
+        // type. The name of a type is only stable between builds with the same compiler.
+        template <typename T>
+        auto persistent_type_tag() noexcept -> std::uint64_t {
+            auto hash = std::uint64_t(0xcbf29ce484222325);
+
+            auto mix = [&](std::uint64_t byte) {
+                hash = (hash ^ byte) * 0x100000001b3;
+            };
+
+            for (auto name = typeid(T).name(); *name != '\0'; ++name) {
+                mix(static_cast<unsigned char>(*name));
+            }
+
+            for (auto shift = 0; shift < 64; shift += 8) {
+                mix((sizeof(T) >> shift) & 0xff);
+                mix((alignof(T) >> shift) & 0xff);
+            }
+
+            return hash;
+        }
+
+        template <typename T>
+        struct persistent_root {
+            std::uint64_t type_tag;
+            std::uint32_t version;
+            box<T, mapped_allocator<T>> value;
+
+            template <typename... Args>
+            persistent_root(std::uint32_t version, mapped_region& region, Args&&... args)
+                : type_tag(persistent_type_tag<T>()), version(version), value(mapped_allocator<T>(region)) {
+                value.emplace(std::forward<Args>(args)...);
+            }
+        };
+    }
+
+    // A box whose element lives in a file and survives the process. Opening the file again maps it back into
+    // memory instead of reading it, so that even large elements are available right away; a version number and a
+    // tag of the element type are checked to make sure the file holds what the caller expects.
+    //
+    // The element is never destroyed, and has to refer to other objects in the file through `offset_ptr`s, e.g. by
+    // allocating them with the box's allocator. Use `flush` to make changes durable.
+    template <typename T>
+    class persistent_box {
+        private:
+        using m_root_type = detail::persistent_root<T>;
+
+        mapped_region m_region;
+        m_root_type* m_root;
+
+        persistent_box(mapped_region region, m_root_type* root) noexcept
+            : m_region(std::move(region)), m_root(root) {}
+
+        public:
+        using value_type = T;
+        using box_type = box<T, mapped_allocator<T>>;
+        using allocator_type = mapped_allocator<T>;
+
+        // Creates the file with room for `size` bytes, replacing whatever was in it, and constructs the element
+        // from `args`.
+        template <typename... Args>
+        static auto create(std::string const& path, std::size_t size, std::uint32_t version, Args&&... args)
+            -> persistent_box {
+            auto region = mapped_region::create_file(path, size);
+            auto root = static_cast<m_root_type*>(region.allocate(sizeof(m_root_type), alignof(m_root_type)));
+
+            new (root) m_root_type(version, region, std::forward<Args>(args)...);
+            region.set_root(root);
+            return persistent_box(std::move(region), root);
+        }
+
+        // Throws `std::runtime_error` if the file was not created for `T`, or for another version.
+        static auto open(std::string const& path, std::uint32_t version) -> persistent_box {
+            auto region = mapped_region::open_file(path);
+            auto root = region.template root<m_root_type>();
+
+            if (root == nullptr || root->type_tag != detail::persistent_type_tag<T>()) {
+                throw std::runtime_error("persistent box holds another type: " + path);
+            }
+
+            if (root->version != version) {
+                throw std::runtime_error("persistent box has another version: " + path);
+            }
+
+            return persistent_box(std::move(region), root);
+        }
+
+        // Opens the file if it exists, and creates it otherwise.
+        template <typename... Args>
+        static auto open_or_create(std::string const& path, std::size_t size, std::uint32_t version,
+                                   Args&&... args) -> persistent_box {
+            if (::access(path.c_str(), F_OK) == 0) {
+                return open(path, version);
+            }
+
+            return create(path, size, version, std::forward<Args>(args)...);
+        }
+
+        persistent_box(persistent_box&&) noexcept = default;
+        auto operator=(persistent_box&&) noexcept -> persistent_box& = default;
+
+        void flush() const {
+            m_region.flush();
+        }
+
+        auto version() const noexcept -> std::uint32_t {
+            return m_root->version;
+        }
+
+        // The box in the file, e.g. to replace its element or to allocate more objects next to it.
+        auto get_box() noexcept -> box_type& {
+            return m_root->value;
+        }
+
+        auto get_box() const noexcept -> box_type const& {
+            return m_root->value;
+        }
+
+        auto get_allocator() const noexcept -> allocator_type {
+            return m_root->value.get_allocator();
+        }
+
+        auto has_value() const noexcept -> bool {
+            return m_root->value.has_value();
+        }
+
+        auto value() noexcept -> T& {
+            return m_root->value.value();
+        }
+
+        auto value() const noexcept -> T const& {
+            return m_root->value.value();
+        }
+
+        auto operator*() noexcept -> T& {
+            return *m_root->value;
+        }
+
+        auto operator*() const noexcept -> T const& {
+            return *m_root->value;
+        }
+
+        auto operator->() noexcept -> T* {
+            return std::addressof(*m_root->value);
+        }
+
+        auto operator->() const noexcept -> T const* {
+            return std::addressof(*m_root->value);
+        }
+    };
+}
+
+#endif // BEN_PERSISTENT_BOX_HPP
@@ -0,0 +1,431 @@
+#ifndef BEN_POLYMORPHIC_BOX_HPP
+#define BEN_POLYMORPHIC_BOX_HPP
+
+#include "box.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace ben {
+
+    // A box for class hierarchies: it can hold an object of any type derived from `Base` and copies it as that
+    // type instead of slicing it. Copying, moving and destroying go through a single pointer to a table of
+    // function pointers generated for each derived type, so the hierarchy needs neither a virtual `clone()` nor a
+    // virtual destructor.
+    //
+    // Derived types that fit into `InlineBytes`, are not over-aligned and are nothrow move constructible are
+    // stored inside the box itself; all others are allocated from `Allocator`. Unlike box, erasing a
+    // polymorphic_box releases its memory, since the next element may be of another type.
+    template <typename Base, std::size_t InlineBytes = 0, typename Allocator = std::allocator<Base>>
+    class polymorphic_box;
+
+    template <typename Base, std::size_t InlineBytes, typename Allocator>
+    void swap(polymorphic_box<Base, InlineBytes, Allocator>& a,
+              polymorphic_box<Base, InlineBytes, Allocator>& b) noexcept;
+
+    namespace detail {
+        template <typename Base, typename Allocator>
+        struct polymorphic_vtable {
+            // Creates a copy of `source` either in `buffer` or on the heap.
+            auto (*clone)(Allocator const& alloc, Base const* source, void* buffer) -> Base*;
+            // Moves an inline object from `source` into `buffer`. Heap objects are simply handed over.
+            auto (*move)(Allocator const& alloc, Base* source, void* buffer) noexcept -> Base*;
+            void (*destroy)(Allocator const& alloc, Base* ptr) noexcept;
+        };
+
+        template <typename Base, typename Derived, typename Allocator, bool Inline>
+        struct polymorphic_ops {
+            using allocator_type = typename std::allocator_traits<Allocator>::template rebind_alloc<Derived>;
+            using traits = std::allocator_traits<allocator_type>;
+
+            static_assert(std::is_same_v<typename traits::pointer, Derived*>,
+                "polymorphic_box requires an allocator with raw pointers");
+
+            template <typename... Args>
+            static auto create(Allocator const& alloc, void* buffer, Args&&... args) -> Base* {
+                auto derived_alloc = allocator_type(alloc);
+
+                if constexpr (Inline) {
+                    auto ptr = static_cast<Derived*>(buffer);
+                    traits::construct(derived_alloc, ptr, std::forward<Args>(args)...);
+                    return ptr;
+                } else {
+                    auto ptr = traits::allocate(derived_alloc, 1);
+
+                    try {
+                        traits::construct(derived_alloc, ptr, std::forward<Args>(args)...);
+                    } catch (...) {
+                        traits::deallocate(derived_alloc, ptr, 1);
+                        throw;
+                    }
+
+                    return ptr;
+                }
+            }
+
+            static auto clone(Allocator const& alloc, Base const* source, void* buffer) -> Base* {
+                return create(alloc, buffer, static_cast<Derived const&>(*source));
+            }
+
+            static auto move(Allocator const& alloc, Base* source, void* buffer) noexcept -> Base* {
+                if constexpr (Inline) {
+                    auto ptr = create(alloc, buffer, std::move(static_cast<Derived&>(*source)));
+                    destroy(alloc, source);
+                    return ptr;
+                } else {
+                    return source;
+                }
+            }
+
+            static void destroy(Allocator const& alloc, Base* ptr) noexcept {
+                auto derived_alloc = allocator_type(alloc);
+                auto derived = static_cast<Derived*>(ptr);
+
+                traits::destroy(derived_alloc, derived);
+
+                if constexpr (!Inline) {
+                    traits::deallocate(derived_alloc, derived, 1);
+                }
+            }
+
+            static constexpr auto vtable = polymorphic_vtable<Base, Allocator>{&clone, &move, &destroy};
+        };
+
+        template <std::size_t Size>
+        class polymorphic_buffer {
+            private:
+            alignas(std::max_align_t) unsigned char m_buffer[Size];
+
+            public:
+            // User-provided so that value-initialization does not zero the buffer.
+            polymorphic_buffer() noexcept {}
+
+            auto data() noexcept -> void* {
+                return m_buffer;
+            }
+
+            auto contains(void const* ptr) const noexcept -> bool {
+                auto address = static_cast<unsigned char const*>(ptr);
+                return std::less_equal<>()(m_buffer, address) && std::less<>()(address, m_buffer + Size);
+            }
+        };
+
+        // Without a buffer, no space is wasted on one.
+        template <>
+        class polymorphic_buffer<0> {
+            public:
+            auto data() noexcept -> void* {
+                return nullptr;
+            }
+
+            auto contains(void const*) const noexcept -> bool {
+                return false;
+            }
+        };
+    }
+
+    template <typename Base, std::size_t InlineBytes, typename Allocator>
+    class polymorphic_box {
+        private:
+        using m_traits = std::allocator_traits<Allocator>;
+        using m_vtable_type = detail::polymorphic_vtable<Base, Allocator>;
+
+        template <typename Derived>
+        static constexpr bool m_is_derived = std::is_base_of_v<Base, Derived>
+            && std::is_copy_constructible_v<Derived>;
+
+        template <typename Derived>
+        static constexpr bool m_fits_inline = sizeof(Derived) <= InlineBytes
+            && alignof(Derived) <= alignof(std::max_align_t)
+            && std::is_nothrow_move_constructible_v<Derived>;
+
+        template <typename Derived>
+        using m_ops = detail::polymorphic_ops<Base, Derived, Allocator, m_fits_inline<Derived>>;
+
+        public:
+        using value_type = Base;
+        using allocator_type = Allocator;
+        using size_type = typename m_traits::size_type;
+        using difference_type = typename m_traits::difference_type;
+        using reference = Base&;
+        using const_reference = Base const&;
+        using pointer = Base*;
+        using const_pointer = Base const*;
+        using iterator = Base*;
+        using const_iterator = Base const*;
+
+        private:
+        // The state is never copied as a whole, since `ptr` may point into the buffer.
+        struct m_state_type : detail::polymorphic_buffer<InlineBytes> {
+            Base* ptr = nullptr;
+            m_vtable_type const* vtable = nullptr;
+
+            m_state_type() = default;
+            m_state_type(m_state_type const&) = delete;
+            auto operator=(m_state_type const&) -> m_state_type& = delete;
+        };
+
+        detail::compressed_pair<allocator_type, m_state_type> m_storage;
+
+        auto m_alloc() noexcept -> allocator_type& {
+            return m_storage.first();
+        }
+
+        auto m_alloc() const noexcept -> allocator_type const& {
+            return m_storage.first();
+        }
+
+        auto m_state() noexcept -> m_state_type& {
+            return m_storage.second();
+        }
+
+        auto m_state() const noexcept -> m_state_type const& {
+            return m_storage.second();
+        }
+
+        auto is_inline() const noexcept -> bool {
+            return m_state().contains(m_state().ptr);
+        }
+
+        void set_state(Base* ptr, m_vtable_type const* vtable) noexcept {
+            m_state().ptr = ptr;
+            m_state().vtable = vtable;
+        }
+
+        // Strong exception guarantee: the old element is only destroyed once the new one has been created. Inline
+        // elements are the exception, as they have to be destroyed to make room in the buffer.
+        template <typename Derived, typename... Args>
+        void replace_value(Args&&... args) {
+            static_assert(m_is_derived<Derived>, "polymorphic_box requires copyable types derived from Base");
+
+            if constexpr (m_fits_inline<Derived>) {
+                erase();
+            }
+
+            auto ptr = m_ops<Derived>::create(m_alloc(), m_state().data(), std::forward<Args>(args)...);
+
+            if constexpr (!m_fits_inline<Derived>) {
+                erase();
+            }
+
+            set_state(ptr, &m_ops<Derived>::vtable);
+        }
+
+        void clone_from(polymorphic_box const& other) {
+            if (!other.has_value()) {
+                erase();
+                return;
+            }
+
+            if (other.is_inline()) {
+                erase();
+            }
+
+            auto ptr = other.m_state().vtable->clone(m_alloc(), other.m_state().ptr, m_state().data());
+
+            if (!other.is_inline()) {
+                erase();
+            }
+
+            set_state(ptr, other.m_state().vtable);
+        }
+
+        // Takes over the element of `other`, which must not use different memory than ours. Expects this box to
+        // be empty.
+        void steal(polymorphic_box& other) noexcept {
+            if (!other.has_value()) {
+                return;
+            }
+
+            auto ptr = other.m_state().vtable->move(m_alloc(), other.m_state().ptr, m_state().data());
+            set_state(ptr, other.m_state().vtable);
+            other.set_state(nullptr, nullptr);
+        }
+
+        friend void swap<Base, InlineBytes, Allocator>(polymorphic_box<Base, InlineBytes, Allocator>& a,
+                                                       polymorphic_box<Base, InlineBytes, Allocator>& b) noexcept;
+
+        public:
+        polymorphic_box() noexcept(noexcept(Allocator())) {}
+        explicit polymorphic_box(allocator_type const& alloc) noexcept : m_storage(alloc) {}
+
+        template <typename Derived, typename = std::enable_if_t<m_is_derived<std::decay_t<Derived>>>>
+        explicit polymorphic_box(Derived&& element, allocator_type const& alloc = Allocator())
+            : m_storage(alloc) {
+            replace_value<std::decay_t<Derived>>(std::forward<Derived>(element));
+        }
+
+        template <typename Derived, typename... Args>
+        explicit polymorphic_box(std::in_place_type_t<Derived>, Args&&... args) {
+            replace_value<Derived>(std::forward<Args>(args)...);
+        }
+
+        polymorphic_box(polymorphic_box const& other)
+            : m_storage(m_traits::select_on_container_copy_construction(other.m_alloc())) {
+            clone_from(other);
+        }
+
+        polymorphic_box(polymorphic_box&& other) noexcept : m_storage(std::move(other.m_alloc())) {
+            steal(other);
+        }
+
+        ~polymorphic_box() {
+            erase();
+        }
+
+        auto operator=(polymorphic_box const& other) -> polymorphic_box& {
+            if (this == &other) {
+                return *this;
+            }
+
+            if constexpr (m_traits::propagate_on_container_copy_assignment::value) {
+                if (m_alloc() != other.m_alloc()) {
+                    erase();
+                    m_alloc() = other.m_alloc();
+                }
+            }
+
+            clone_from(other);
+            return *this;
+        }
+
+        // With unequal allocators that do not propagate, a heap element has to be copied into memory from our own
+        // allocator instead.
+        auto operator=(polymorphic_box&& other) noexcept(m_traits::propagate_on_container_move_assignment::value
+                                                         || m_traits::is_always_equal::value) -> polymorphic_box& {
+            if (this == &other) {
+                return *this;
+            }
+
+            if (m_traits::is_always_equal::value || m_alloc() == other.m_alloc() || other.is_inline()) {
+                erase();
+                steal(other);
+            } else if constexpr (m_traits::propagate_on_container_move_assignment::value) {
+                erase();
+                m_alloc() = std::move(other.m_alloc());
+                steal(other);
+            } else {
+                clone_from(other);
+                other.erase();
+            }
+
+            return *this;
+        }
+
+        auto get_allocator() const noexcept -> allocator_type {
+            return m_alloc();
+        }
+
+        auto value() noexcept -> reference {
+            return *m_state().ptr;
+        }
+
+        auto value() const noexcept -> const_reference {
+            return *m_state().ptr;
+        }
+
+        auto operator*() noexcept -> reference {
+            return value();
+        }
+
+        auto operator*() const noexcept -> const_reference {
+            return value();
+        }
+
+        auto operator->() noexcept -> pointer {
+            return m_state().ptr;
+        }
+
+        auto operator->() const noexcept -> const_pointer {
+            return m_state().ptr;
+        }
+
+        auto safe_value() noexcept -> std::optional<std::reference_wrapper<value_type>> {
+            if (has_value()) {
+                return value();
+            }
+
+            return std::nullopt;
+        }
+
+        auto safe_value() const noexcept -> std::optional<std::reference_wrapper<value_type const>> {
+            if (has_value()) {
+                return value();
+            }
+
+            return std::nullopt;
+        }
+
+        auto has_value() const noexcept -> bool {
+            return m_state().ptr != nullptr;
+        }
+
+        auto size() const noexcept -> size_type {
+            return has_value() ? 1 : 0;
+        }
+
+        template <typename Derived, typename... Args>
+        void emplace(Args&&... args) {
+            replace_value<Derived>(std::forward<Args>(args)...);
+        }
+
+        template <typename Derived, typename = std::enable_if_t<m_is_derived<std::decay_t<Derived>>>>
+        void push(Derived&& val) {
+            emplace<std::decay_t<Derived>>(std::forward<Derived>(val));
+        }
+
+        void erase() noexcept {
+            if (!has_value()) {
+                return;
+            }
+
+            m_state().vtable->destroy(m_alloc(), m_state().ptr);
+            set_state(nullptr, nullptr);
+        }
+
+        auto begin() noexcept -> iterator {
+            return m_state().ptr;
+        }
+
+        auto begin() const noexcept -> const_iterator {
+            return m_state().ptr;
+        }
+
+        auto end() noexcept -> iterator {
+            return has_value() ? m_state().ptr + 1 : nullptr;
+        }
+
+        auto end() const noexcept -> const_iterator {
+            return has_value() ? m_state().ptr + 1 : nullptr;
+        }
+
+        auto cbegin() const noexcept -> const_iterator {
+            return begin();
+        }
+
+        auto cend() const noexcept -> const_iterator {
+            return end();
+        }
+    };
+
+    template <typename Base, std::size_t InlineBytes, typename Allocator>
+    void swap(polymorphic_box<Base, InlineBytes, Allocator>& a,
+              polymorphic_box<Base, InlineBytes, Allocator>& b) noexcept {
+        using std::swap;
+
+        if constexpr (std::allocator_traits<Allocator>::propagate_on_container_swap::value) {
+            swap(a.m_alloc(), b.m_alloc());
+        }
+
+        auto tmp = polymorphic_box<Base, InlineBytes, Allocator>(a.m_alloc());
+        tmp.steal(a);
+        a.steal(b);
+        b.steal(tmp);
+    }
+}
+
+#endif // BEN_POLYMORPHIC_BOX_HPP
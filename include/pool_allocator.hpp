@@ -0,0 +1,218 @@
+#ifndef BEN_POOL_ALLOCATOR_HPP
+#define BEN_POOL_ALLOCATOR_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <type_traits>
+
+namespace ben {
+
+    namespace detail {
+        // Slabs are aligned to their size, so the slab (and with it the owning pool) of any block can be found by
+        // masking off the lower bits of its address.
+        inline constexpr std::size_t pool_slab_size = std::size_t(64) * 1024;
+
+        class pool;
+
+        struct pool_slab {
+            pool* owner;
+            pool_slab* next;
+        };
+
+        struct pool_block {
+            pool_block* next;
+        };
+
+        // A free list of fixed-size blocks. Only the owning thread allocates and pushes to `m_free`; all other
+        // threads return blocks through `m_remote_free`, which the owner takes over in one go once it runs dry.
+        class pool {
+            private:
+            std::size_t m_block_size;
+            std::size_t m_alignment;
+
+            pool_block* m_free = nullptr;
+            std::atomic<pool_block*> m_remote_free{nullptr};
+
+            pool_slab* m_slabs = nullptr;
+            unsigned char* m_bump = nullptr;
+            unsigned char* m_bump_end = nullptr;
+
+            auto carve() -> void* {
+                if (m_bump == m_bump_end) {
+                    auto memory = ::operator new(pool_slab_size, std::align_val_t(pool_slab_size));
+                    auto slab = new (memory) pool_slab{this, m_slabs};
+                    m_slabs = slab;
+
+                    auto first = (sizeof(pool_slab) + m_alignment - 1) / m_alignment * m_alignment;
+                    auto count = (pool_slab_size - first) / m_block_size;
+
+                    m_bump = static_cast<unsigned char*>(memory) + first;
+                    m_bump_end = m_bump + count * m_block_size;
+                }
+
+                auto block = m_bump;
+                m_bump += m_block_size;
+                return block;
+            }
+
+            public:
+            // Links orphaned pools, see pool_registry.
+            pool* next_orphan = nullptr;
+
+            pool(std::size_t block_size, std::size_t alignment) noexcept
+                : m_block_size(block_size), m_alignment(alignment) {}
+
+            auto allocate() -> void* {
+                if (m_free == nullptr) {
+                    m_free = m_remote_free.exchange(nullptr, std::memory_order_acquire);
+
+                    if (m_free == nullptr) {
+                        return carve();
+                    }
+                }
+
+                auto block = m_free;
+                m_free = block->next;
+                return block;
+            }
+
+            void deallocate_local(void* ptr) noexcept {
+                m_free = new (ptr) pool_block{m_free};
+            }
+
+            void deallocate_remote(void* ptr) noexcept {
+                auto block = new (ptr) pool_block{m_remote_free.load(std::memory_order_relaxed)};
+
+                while (!m_remote_free.compare_exchange_weak(block->next, block, std::memory_order_release,
+                                                            std::memory_order_relaxed)) {}
+            }
+
+            static auto owner_of(void* ptr) noexcept -> pool* {
+                auto address = reinterpret_cast<std::uintptr_t>(ptr) & ~(pool_slab_size - 1);
+                return reinterpret_cast<pool_slab*>(address)->owner;
+            }
+        };
+
+        // Hands out one pool per thread and block size. Blocks may outlive the thread that allocated them, so when
+        // a thread exits its pool is not destroyed but orphaned, to be adopted by the next thread that needs one.
+        // Pools and their slabs are thus only ever released to the system when the process ends.
+        template <std::size_t BlockSize, std::size_t Alignment>
+        class pool_registry {
+            private:
+            struct thread_guard {
+                ~thread_guard() {
+                    if (local != nullptr) {
+                        auto lock = std::lock_guard(orphans_mutex);
+                        local->next_orphan = orphans;
+                        orphans = local;
+                        local = nullptr;
+                    }
+                }
+            };
+
+            static inline std::mutex orphans_mutex;
+            static inline pool* orphans = nullptr;
+
+            // Trivially destructible, so it remains usable while other thread-local objects are destroyed.
+            static inline thread_local pool* local = nullptr;
+            static inline thread_local thread_guard guard;
+
+            static auto acquire() -> pool* {
+                {
+                    auto lock = std::lock_guard(orphans_mutex);
+
+                    if (orphans != nullptr) {
+                        local = orphans;
+                        orphans = orphans->next_orphan;
+                    }
+                }
+
+                if (local == nullptr) {
+                    local = new pool(BlockSize, Alignment);
+                }
+
+                // Touching the guard ensures it is constructed and thus destroyed at thread exit.
+                static_cast<void>(&guard);
+                return local;
+            }
+
+            public:
+            static auto allocate() -> void* {
+                auto p = local != nullptr ? local : acquire();
+                return p->allocate();
+            }
+
+            static void deallocate(void* ptr) noexcept {
+                auto owner = pool::owner_of(ptr);
+
+                if (owner == local) {
+                    owner->deallocate_local(ptr);
+                } else {
+                    owner->deallocate_remote(ptr);
+                }
+            }
+        };
+    }
+
+    // An allocator tailored to box: single objects are served from a thread-local free list of fixed-size blocks,
+    // which are carved from large slabs. Blocks may be freed from any thread. Requests for more than one object
+    // and objects too large for the slabs go to the global `operator new` instead.
+    template <typename T>
+    class pool_allocator {
+        private:
+        static constexpr auto m_alignment = alignof(T) > alignof(detail::pool_block)
+            ? alignof(T) : alignof(detail::pool_block);
+        static constexpr auto m_size = sizeof(T) > sizeof(detail::pool_block) ? sizeof(T) : sizeof(detail::pool_block);
+        static constexpr auto m_block_size = (m_size + m_alignment - 1) / m_alignment * m_alignment;
+
+        static constexpr bool m_pooled = m_block_size <= detail::pool_slab_size / 16;
+
+        using m_registry = detail::pool_registry<m_block_size, m_alignment>;
+
+        public:
+        using value_type = T;
+        using is_always_equal = std::true_type;
+
+        template <typename U>
+        struct rebind {
+            using other = pool_allocator<U>;
+        };
+
+        pool_allocator() noexcept = default;
+
+        template <typename U>
+        pool_allocator(pool_allocator<U> const&) noexcept {}
+
+        auto allocate(std::size_t n) -> T* {
+            if (m_pooled && n == 1) {
+                return static_cast<T*>(m_registry::allocate());
+            }
+
+            return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(alignof(T))));
+        }
+
+        void deallocate(T* ptr, std::size_t n) noexcept {
+            if (m_pooled && n == 1) {
+                m_registry::deallocate(ptr);
+                return;
+            }
+
+            ::operator delete(ptr, std::align_val_t(alignof(T)));
+        }
+
+        template <typename U>
+        friend auto operator==(pool_allocator const&, pool_allocator<U> const&) noexcept -> bool {
+            return true;
+        }
+
+        template <typename U>
+        friend auto operator!=(pool_allocator const&, pool_allocator<U> const&) noexcept -> bool {
+            return false;
+        }
+    };
+}
+
+#endif // BEN_POOL_ALLOCATOR_HPP
@@ -0,0 +1,82 @@
+#ifndef BEN_RELOCATE_HPP
+#define BEN_RELOCATE_HPP
+
+#include "box.hpp"
+
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+
+namespace ben {
+
+    // Move-constructs the elements of [first, last) into the uninitialized memory at `d_first` and destroys the
+    // originals. Trivially relocatable elements in contiguous memory are copied with a single `memcpy`.
+    //
+    // If a move constructor throws, the elements that were already constructed at the destination are destroyed
+    // and all source elements are left alive, though some of them may have been moved from.
+    template <typename InputIt, typename ForwardIt>
+    auto uninitialized_relocate(InputIt first, InputIt last, ForwardIt d_first) -> ForwardIt {
+        using value_type = typename std::iterator_traits<ForwardIt>::value_type;
+
+        if constexpr (std::is_pointer_v<InputIt> && std::is_same_v<InputIt, ForwardIt>
+                      && is_trivially_relocatable_v<value_type>) {
+            auto const count = static_cast<std::size_t>(last - first);
+
+            if (count != 0) {
+                std::memcpy(static_cast<void*>(d_first), static_cast<void const*>(first), count * sizeof(value_type));
+            }
+
+            return d_first + count;
+        } else {
+            auto result = std::uninitialized_move(first, last, d_first);
+            std::destroy(first, last);
+            return result;
+        }
+    }
+
+    // Moves the `size` elements at the start of `data`, which holds room for `capacity` elements, into newly
+    // allocated room for `new_capacity` elements and gives back the old memory. Returns the new memory.
+    //
+    // Elements that are neither trivially relocatable nor nothrow move constructible are copied instead, so that
+    // the old elements stay untouched if anything throws, just like the reallocation of `std::vector`.
+    template <typename Allocator>
+    auto relocate_grow(Allocator& alloc, typename Allocator::value_type* data, std::size_t size,
+                       std::size_t capacity, std::size_t new_capacity) -> typename Allocator::value_type* {
+        using traits = std::allocator_traits<Allocator>;
+        using value_type = typename traits::value_type;
+
+        static_assert(std::is_same_v<typename traits::pointer, value_type*>,
+                      "relocate_grow requires the allocator to use raw pointers");
+
+        auto new_data = traits::allocate(alloc, new_capacity);
+
+        if constexpr (is_trivially_relocatable_v<value_type> || std::is_nothrow_move_constructible_v<value_type>
+                      || !std::is_copy_constructible_v<value_type>) {
+            try {
+                uninitialized_relocate(data, data + size, new_data);
+            } catch (...) {
+                traits::deallocate(alloc, new_data, new_capacity);
+                throw;
+            }
+        } else {
+            try {
+                std::uninitialized_copy(data, data + size, new_data);
+            } catch (...) {
+                traits::deallocate(alloc, new_data, new_capacity);
+                throw;
+            }
+
+            std::destroy(data, data + size);
+        }
+
+        if (data != nullptr) {
+            traits::deallocate(alloc, data, capacity);
+        }
+
+        return new_data;
+    }
+}
+
+#endif // BEN_RELOCATE_HPP
@@ -0,0 +1,352 @@
+#ifndef BEN_SBO_BOX_HPP
+#define BEN_SBO_BOX_HPP
+
+#include "box.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace ben {
+
+    // A box that stores its element inside of itself instead of on the heap. The allocator is still used to
+    // construct and destroy the element, but never to allocate memory.
+    template <typename T, typename Allocator = std::allocator<T>>
+    class inline_box;
+
+    template <typename T, typename Allocator>
+    void swap(inline_box<T, Allocator>& a, inline_box<T, Allocator>& b) noexcept(
+        std::is_nothrow_move_constructible_v<T> && std::is_nothrow_swappable_v<T>);
+
+    namespace detail {
+        template <typename T>
+        class inline_state {
+            private:
+            alignas(T) unsigned char m_buffer[sizeof(T)];
+            bool m_has_value = false;
+
+            public:
+            // User-provided so that value-initialization does not zero the buffer.
+            inline_state() noexcept {}
+
+            auto ptr() noexcept -> T* {
+                return std::launder(reinterpret_cast<T*>(m_buffer));
+            }
+
+            auto ptr() const noexcept -> T const* {
+                return std::launder(reinterpret_cast<T const*>(m_buffer));
+            }
+
+            auto has_value() const noexcept -> bool {
+                return m_has_value;
+            }
+
+            void set_has_value(bool has_value) noexcept {
+                m_has_value = has_value;
+            }
+        };
+    }
+
+    template <typename T, typename Allocator>
+    class inline_box {
+        private:
+        using m_traits = std::allocator_traits<Allocator>;
+
+        public:
+        using value_type = T;
+        using allocator_type = Allocator;
+        using size_type = typename m_traits::size_type;
+        using difference_type = typename m_traits::difference_type;
+        using reference = T&;
+        using const_reference = T const&;
+        using pointer = T*;
+        using const_pointer = T const*;
+        using iterator = T*;
+        using const_iterator = T const*;
+
+        private:
+        detail::compressed_pair<allocator_type, detail::inline_state<T>> m_storage;
+
+        auto m_alloc() noexcept -> allocator_type& {
+            return m_storage.first();
+        }
+
+        auto m_alloc() const noexcept -> allocator_type const& {
+            return m_storage.first();
+        }
+
+        auto m_state() noexcept -> detail::inline_state<T>& {
+            return m_storage.second();
+        }
+
+        auto m_state() const noexcept -> detail::inline_state<T> const& {
+            return m_storage.second();
+        }
+
+        template <typename... Args>
+        void make_inline_value(Args&&... args) {
+            m_traits::construct(m_alloc(), m_state().ptr(), std::forward<Args>(args)...);
+            m_state().set_has_value(true);
+        }
+
+        template <typename... Args>
+        void reconstruct_inline_value(Args&&... args) {
+            erase();
+            make_inline_value(std::forward<Args>(args)...);
+        }
+
+        // Replaces the element the way `adaptive_emplace` does for box.
+        template <typename... Args>
+        void replace_existing_value(Args&&... args) {
+            if constexpr (detail::reconstructs<adaptive_emplace, T, Args...>
+                          && detail::copies_arguments<adaptive_emplace, T, Args...>) {
+                reconstruct_inline_value(std::decay_t<Args>(args)...);
+            } else if constexpr (detail::reconstructs<adaptive_emplace, T, Args...>) {
+                reconstruct_inline_value(std::forward<Args>(args)...);
+            } else if constexpr (detail::is_direct_assignment<T, Args...>) {
+                value() = (std::forward<Args>(args), ...);
+            } else {
+                value() = value_type(std::forward<Args>(args)...);
+            }
+        }
+
+        template <typename... Args>
+        void replace_inline_value(Args&&... args) {
+            if (m_state().has_value()) {
+                replace_existing_value(std::forward<Args>(args)...);
+            } else {
+                make_inline_value(std::forward<Args>(args)...);
+            }
+        }
+
+        friend void swap<T, Allocator>(inline_box<T, Allocator>& a, inline_box<T, Allocator>& b) noexcept(
+            std::is_nothrow_move_constructible_v<T> && std::is_nothrow_swappable_v<T>);
+
+        public:
+        inline_box() noexcept(noexcept(Allocator())) {}
+        explicit inline_box(allocator_type const& alloc) noexcept : m_storage(alloc, detail::inline_state<T>()) {}
+
+        explicit inline_box(T const& element, allocator_type const& alloc = Allocator())
+            : m_storage(alloc, detail::inline_state<T>()) {
+            make_inline_value(element);
+        }
+
+        explicit inline_box(T&& element, allocator_type const& alloc = Allocator())
+            : m_storage(alloc, detail::inline_state<T>()) {
+            make_inline_value(std::move(element));
+        }
+
+        inline_box(inline_box const& other)
+            : m_storage(m_traits::select_on_container_copy_construction(other.m_alloc()), detail::inline_state<T>()) {
+
+            if (other.has_value()) {
+                make_inline_value(other.value());
+            }
+        }
+
+        // Like box, a moved-from inline_box is left empty.
+        inline_box(inline_box&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+            : m_storage(std::move(other.m_alloc()), detail::inline_state<T>()) {
+
+            if (other.has_value()) {
+                make_inline_value(std::move(other.value()));
+                other.erase();
+            }
+        }
+
+        ~inline_box() {
+            erase();
+        }
+
+        auto operator=(inline_box const& other) -> inline_box& {
+            if (this == &other) {
+                return *this;
+            }
+
+            if constexpr (m_traits::propagate_on_container_copy_assignment::value) {
+                if (m_alloc() != other.m_alloc()) {
+                    erase();
+                }
+
+                m_alloc() = other.m_alloc();
+            }
+
+            if (other.has_value()) {
+                replace_inline_value(other.value());
+            } else {
+                erase();
+            }
+
+            return *this;
+        }
+
+        auto operator=(inline_box&& other) noexcept(
+            std::is_nothrow_move_constructible_v<T> && std::is_nothrow_move_assignable_v<T>) -> inline_box& {
+
+            if (this == &other) {
+                return *this;
+            }
+
+            if constexpr (m_traits::propagate_on_container_move_assignment::value) {
+                erase();
+                m_alloc() = std::move(other.m_alloc());
+            }
+
+            if (other.has_value()) {
+                replace_inline_value(std::move(other.value()));
+                other.erase();
+            } else {
+                erase();
+            }
+
+            return *this;
+        }
+
+        auto get_allocator() const noexcept -> allocator_type {
+            return m_alloc();
+        }
+
+        auto value() noexcept -> reference {
+            return *m_state().ptr();
+        }
+
+        auto value() const noexcept -> const_reference {
+            return *m_state().ptr();
+        }
+
+        auto operator*() noexcept -> reference {
+            return value();
+        }
+
+        auto operator*() const noexcept -> const_reference {
+            return value();
+        }
+
+        auto safe_value() noexcept -> std::optional<std::reference_wrapper<value_type>> {
+            if (has_value()) {
+                return value();
+            }
+
+            return std::nullopt;
+        }
+
+        auto safe_value() const noexcept -> std::optional<std::reference_wrapper<value_type const>> {
+            if (has_value()) {
+                return value();
+            }
+
+            return std::nullopt;
+        }
+
+        auto has_value() const noexcept -> bool {
+            return m_state().has_value();
+        }
+
+        auto size() const noexcept -> size_type {
+            return has_value() ? 1 : 0;
+        }
+
+        template <typename... Args>
+        void emplace(Args&&... args) {
+            replace_inline_value(std::forward<Args>(args)...);
+        }
+
+        void push(T const& val) {
+            replace_inline_value(val);
+        }
+
+        void push(T&& val) {
+            replace_inline_value(std::move(val));
+        }
+
+        void erase() noexcept {
+            if (!has_value()) {
+                return;
+            }
+
+            m_traits::destroy(m_alloc(), m_state().ptr());
+            m_state().set_has_value(false);
+        }
+
+        // The storage is part of the box, so these only exist to share the interface of box.
+        void reset() noexcept {
+            erase();
+        }
+
+        auto capacity() const noexcept -> size_type {
+            return 1;
+        }
+
+        void reserve() noexcept {}
+
+        void shrink_to_fit() noexcept {}
+
+        auto begin() noexcept -> iterator {
+            return has_value() ? m_state().ptr() : nullptr;
+        }
+
+        auto begin() const noexcept -> const_iterator {
+            return has_value() ? m_state().ptr() : nullptr;
+        }
+
+        auto end() noexcept -> iterator {
+            return has_value() ? m_state().ptr() + 1 : nullptr;
+        }
+
+        auto end() const noexcept -> const_iterator {
+            return has_value() ? m_state().ptr() + 1 : nullptr;
+        }
+
+        auto cbegin() const noexcept -> const_iterator {
+            return begin();
+        }
+
+        auto cend() const noexcept -> const_iterator {
+            return end();
+        }
+    };
+
+    template <typename T, typename Allocator>
+    void swap(inline_box<T, Allocator>& a, inline_box<T, Allocator>& b) noexcept(
+        std::is_nothrow_move_constructible_v<T> && std::is_nothrow_swappable_v<T>) {
+        using std::swap;
+
+        if constexpr (std::allocator_traits<Allocator>::propagate_on_container_swap::value) {
+            swap(a.m_alloc(), b.m_alloc());
+        }
+
+        if (a.has_value() && b.has_value()) {
+            swap(a.value(), b.value());
+        } else if (a.has_value()) {
+            b.make_inline_value(std::move(a.value()));
+            a.erase();
+        } else if (b.has_value()) {
+            a.make_inline_value(std::move(b.value()));
+            b.erase();
+        }
+    }
+
+    template <typename T, typename Allocator>
+    struct is_trivially_relocatable<inline_box<T, Allocator>>
+        : std::bool_constant<is_trivially_relocatable_v<T> && is_trivially_relocatable_v<Allocator>> {};
+
+    inline constexpr auto default_inline_bytes = 4 * sizeof(void*);
+
+    // Whether an `sbo_box<T, InlineBytes>` stores its element inline. Types that may throw when moved are always
+    // kept on the heap so that moving the box stays noexcept.
+    template <typename T, std::size_t InlineBytes>
+    inline constexpr bool fits_inline = sizeof(T) <= InlineBytes
+        && alignof(T) <= alignof(std::max_align_t)
+        && std::is_nothrow_move_constructible_v<T>;
+
+    // A box that avoids the heap for elements that are small enough, and falls back to a regular box otherwise.
+    // Both alternatives share the same interface.
+    template <typename T, std::size_t InlineBytes = default_inline_bytes, typename Allocator = std::allocator<T>>
+    using sbo_box = std::conditional_t<fits_inline<T, InlineBytes>, inline_box<T, Allocator>, box<T, Allocator>>;
+}
+
+#endif // BEN_SBO_BOX_HPP
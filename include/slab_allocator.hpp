@@ -0,0 +1,198 @@
+#ifndef BEN_SLAB_ALLOCATOR_HPP
+#define BEN_SLAB_ALLOCATOR_HPP
+
+#include "box.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ben {
+
+    namespace detail {
+        // A run of equally sized slots in a single allocation, followed by the slots themselves. Slots are handed
+        // out in order and never reused; the slab is freed once the last allocator referring to it is gone.
+        struct batch_slab {
+            std::atomic<std::size_t> refs{1};
+            std::atomic<std::size_t> used{0};
+            std::size_t slot_size;
+            std::size_t slot_alignment;
+            std::size_t capacity;
+            unsigned char* slots;
+
+            static auto slots_offset(std::size_t alignment) noexcept -> std::size_t {
+                return (sizeof(batch_slab) + alignment - 1) / alignment * alignment;
+            }
+
+            static auto memory_alignment(std::size_t alignment) noexcept -> std::size_t {
+                return alignment > alignof(batch_slab) ? alignment : alignof(batch_slab);
+            }
+
+            static auto create(std::size_t slot_size, std::size_t slot_alignment, std::size_t capacity)
+                -> batch_slab* {
+                auto offset = slots_offset(slot_alignment);
+                auto memory = ::operator new(offset + slot_size * capacity,
+                                             std::align_val_t(memory_alignment(slot_alignment)));
+                auto slab = new (memory) batch_slab();
+
+                slab->slot_size = slot_size;
+                slab->slot_alignment = slot_alignment;
+                slab->capacity = capacity;
+                slab->slots = static_cast<unsigned char*>(memory) + offset;
+                return slab;
+            }
+
+            static void acquire(batch_slab* slab) noexcept {
+                if (slab != nullptr) {
+                    slab->refs.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+
+            static void release(batch_slab* slab) noexcept {
+                if (slab != nullptr && slab->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    auto alignment = memory_alignment(slab->slot_alignment);
+                    slab->~batch_slab();
+                    ::operator delete(static_cast<void*>(slab), std::align_val_t(alignment));
+                }
+            }
+
+            // Returns nullptr once all slots are taken.
+            auto take() noexcept -> void* {
+                if (used.load(std::memory_order_relaxed) >= capacity) {
+                    return nullptr;
+                }
+
+                auto index = used.fetch_add(1, std::memory_order_relaxed);
+                return index < capacity ? slots + index * slot_size : nullptr;
+            }
+
+            auto owns(void const* ptr) const noexcept -> bool {
+                auto address = static_cast<unsigned char const*>(ptr);
+                return address >= slots && address < slots + slot_size * capacity;
+            }
+        };
+    }
+
+    // Serves single objects from a slab of `n` contiguous slots allocated up front, so that the elements of `n`
+    // boxes sit next to each other in memory and are allocated at once. Copies of the allocator share the slab,
+    // which is freed when the last of them is destroyed; boxes keep it alive through their allocator. Once the slab
+    // is used up, and for arrays, the global `operator new` is used instead.
+    //
+    // Slots are not reused, so the slab suits collections that are built once and then mostly read.
+    template <typename T>
+    class slab_allocator {
+        private:
+        template <typename U>
+        friend class slab_allocator;
+
+        detail::batch_slab* m_slab = nullptr;
+
+        auto fits() const noexcept -> bool {
+            return m_slab != nullptr && sizeof(T) <= m_slab->slot_size && alignof(T) <= m_slab->slot_alignment;
+        }
+
+        template <typename U>
+        auto shares_with(slab_allocator<U> const& other) const noexcept -> bool {
+            return m_slab == other.m_slab;
+        }
+
+        public:
+        using value_type = T;
+        using propagate_on_container_copy_assignment = std::true_type;
+        using propagate_on_container_move_assignment = std::true_type;
+        using propagate_on_container_swap = std::true_type;
+
+        template <typename U>
+        struct rebind {
+            using other = slab_allocator<U>;
+        };
+
+        // Without a slab, all memory comes from the global `operator new`.
+        slab_allocator() noexcept = default;
+
+        explicit slab_allocator(std::size_t n)
+            : m_slab(n == 0 ? nullptr : detail::batch_slab::create(sizeof(T), alignof(T), n)) {}
+
+        slab_allocator(slab_allocator const& other) noexcept : m_slab(other.m_slab) {
+            detail::batch_slab::acquire(m_slab);
+        }
+
+        template <typename U>
+        slab_allocator(slab_allocator<U> const& other) noexcept : m_slab(other.m_slab) {
+            detail::batch_slab::acquire(m_slab);
+        }
+
+        auto operator=(slab_allocator const& other) noexcept -> slab_allocator& {
+            detail::batch_slab::acquire(other.m_slab);
+            detail::batch_slab::release(std::exchange(m_slab, other.m_slab));
+            return *this;
+        }
+
+        ~slab_allocator() {
+            detail::batch_slab::release(m_slab);
+        }
+
+        auto allocate(std::size_t n) -> T* {
+            if (n == 1 && fits()) {
+                if (auto slot = m_slab->take()) {
+                    return static_cast<T*>(slot);
+                }
+            }
+
+            return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(alignof(T))));
+        }
+
+        void deallocate(T* ptr, std::size_t) noexcept {
+            if (m_slab != nullptr && m_slab->owns(ptr)) {
+                return;
+            }
+
+            ::operator delete(ptr, std::align_val_t(alignof(T)));
+        }
+
+        // The number of slots that have not been handed out yet.
+        auto remaining() const noexcept -> std::size_t {
+            if (m_slab == nullptr) {
+                return 0;
+            }
+
+            auto used = m_slab->used.load(std::memory_order_relaxed);
+            return used < m_slab->capacity ? m_slab->capacity - used : 0;
+        }
+
+        template <typename U>
+        friend auto operator==(slab_allocator const& a, slab_allocator<U> const& b) noexcept -> bool {
+            return a.shares_with(b);
+        }
+
+        template <typename U>
+        friend auto operator!=(slab_allocator const& a, slab_allocator<U> const& b) noexcept -> bool {
+            return !(a == b);
+        }
+    };
+
+    // The allocator only holds a pointer to its slab.
+    template <typename T>
+    struct is_trivially_relocatable<slab_allocator<T>> : std::true_type {};
+
+    // Creates `n` boxes whose elements are constructed from `args` and stored contiguously in a single slab. Each
+    // box still owns its element: assigning, emplacing and copying work as with any other box, with new elements
+    // coming from the heap.
+    template <typename T, typename... Args>
+    auto make_boxes(std::size_t n, Args const&... args) -> std::vector<box<T, slab_allocator<T>>> {
+        auto alloc = slab_allocator<T>(n);
+        auto boxes = std::vector<box<T, slab_allocator<T>>>();
+        boxes.reserve(n);
+
+        for (auto i = std::size_t(0); i < n; ++i) {
+            boxes.emplace_back(alloc).emplace(args...);
+        }
+
+        return boxes;
+    }
+}
+
+#endif // BEN_SLAB_ALLOCATOR_HPP
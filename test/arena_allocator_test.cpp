@@ -0,0 +1,157 @@
+#include "arena_allocator.hpp"
+#include "box.hpp"
+#include <catch2/catch.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+    template <typename T>
+    using arena_box = ben::box<T, ben::arena_allocator<T>>;
+
+    struct counters {
+        int deallocations = 0;
+        int destructions = 0;
+
+        alignas(std::max_align_t) unsigned char buffer[256];
+        std::size_t used = 0;
+    };
+
+    // Hands out memory from a buffer that is never freed, claims bulk release and counts what box still asks of it.
+    template <typename T>
+    struct bulk_allocator {
+        using value_type = T;
+        using releases_in_bulk = std::true_type;
+
+        counters* stats;
+
+        explicit bulk_allocator(counters& stats) : stats(&stats) {}
+
+        template <typename U>
+        bulk_allocator(bulk_allocator<U> const& other) : stats(other.stats) {}
+
+        auto allocate(std::size_t n) -> T* {
+            auto ptr = stats->buffer + stats->used;
+            stats->used += (n * sizeof(T) + alignof(std::max_align_t) - 1) / alignof(std::max_align_t)
+                * alignof(std::max_align_t);
+
+            return reinterpret_cast<T*>(ptr);
+        }
+
+        void deallocate(T*, std::size_t) noexcept {
+            ++stats->deallocations;
+        }
+
+        template <typename U>
+        void destroy(U* ptr) noexcept {
+            ++stats->destructions;
+            ptr->~U();
+        }
+
+        friend auto operator==(bulk_allocator const& a, bulk_allocator const& b) -> bool {
+            return a.stats == b.stats;
+        }
+
+        friend auto operator!=(bulk_allocator const& a, bulk_allocator const& b) -> bool {
+            return !(a == b);
+        }
+    };
+}
+
+TEST_CASE("arena") {
+    auto a = ben::arena(256);
+
+    auto first = static_cast<unsigned char*>(a.allocate(16, 8));
+    auto second = static_cast<unsigned char*>(a.allocate(16, 8));
+
+    REQUIRE(second == first + 16);
+
+    auto aligned = a.allocate(1, 64);
+    REQUIRE(reinterpret_cast<std::uintptr_t>(aligned) % 64 == 0);
+
+    // Larger than the chunk size.
+    auto large = a.allocate(1000, 8);
+    REQUIRE(large != nullptr);
+
+    a.reset();
+    REQUIRE(a.allocate(16, 8) == first);
+
+    a.release();
+    REQUIRE(a.allocate(16, 8) != nullptr);
+}
+
+TEST_CASE("arena_allocator with box") {
+    auto a = ben::arena();
+    auto alloc = ben::arena_allocator<std::string>(a);
+
+    static_assert(ben::allocator_releases_in_bulk_v<ben::arena_allocator<int>>);
+    static_assert(!ben::allocator_releases_in_bulk_v<std::allocator<int>>);
+
+    SECTION("Equality") {
+        auto other_arena = ben::arena();
+
+        REQUIRE(alloc == ben::arena_allocator<long>(a));
+        REQUIRE(alloc != ben::arena_allocator<long>(other_arena));
+        REQUIRE(ben::arena_allocator<long>(alloc) == alloc);
+    }
+
+    SECTION("Elements are contiguous") {
+        auto boxes = std::vector<arena_box<long>>();
+        boxes.reserve(3);
+
+        for (long i = 0; i < 3; ++i) {
+            boxes.emplace_back(i, ben::arena_allocator<long>(a));
+        }
+
+        REQUIRE(&boxes[1].value() == &boxes[0].value() + 1);
+        REQUIRE(&boxes[2].value() == &boxes[1].value() + 1);
+    }
+
+    SECTION("Copy and move") {
+        // Moving `other` into `box` ties the element to `other_arena`, which therefore has to outlive `box`.
+        auto other_arena = ben::arena();
+        auto box = arena_box<std::string>(std::string("arena"), alloc);
+        auto cpy = box;
+
+        REQUIRE(cpy.value() == "arena");
+        REQUIRE(cpy.get_allocator() == alloc);
+
+        auto other = arena_box<std::string>(std::string("other"), ben::arena_allocator<std::string>(other_arena));
+
+        // The allocator propagates, so the pointer is taken over without copying.
+        auto address = &other.value();
+        box = std::move(other);
+
+        REQUIRE(&box.value() == address);
+        REQUIRE(box.get_allocator().resource().allocate(1, 1) != nullptr);
+    }
+}
+
+TEST_CASE("Bulk released allocators") {
+    auto stats = counters();
+
+    SECTION("Trivially destructible elements are neither destroyed nor deallocated") {
+        {
+            auto box = ben::box<int, bulk_allocator<int>>(5, bulk_allocator<int>(stats));
+            REQUIRE(box.value() == 5);
+        }
+
+        REQUIRE(stats.destructions == 0);
+        REQUIRE(stats.deallocations == 0);
+    }
+
+    SECTION("Other elements are still destroyed") {
+        {
+            auto box = ben::box<std::string, bulk_allocator<std::string>>(std::string("long enough to allocate on "
+                "the heap"), bulk_allocator<std::string>(stats));
+            REQUIRE(box.value().size() > 16);
+        }
+
+        REQUIRE(stats.destructions == 1);
+        REQUIRE(stats.deallocations == 0);
+    }
+}
@@ -0,0 +1,142 @@
+#include "atomic_box.hpp"
+#include <catch2/catch.hpp>
+
+#include <atomic>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+    // Counts live instances, so that tests can tell when retired values are destroyed.
+    struct tracked {
+        static inline std::atomic<int> alive{0};
+
+        long value;
+        long negated;
+
+        explicit tracked(long value) : value(value), negated(-value) {
+            ++alive;
+        }
+
+        tracked(tracked const& other) : value(other.value), negated(other.negated) {
+            ++alive;
+        }
+
+        ~tracked() {
+            --alive;
+        }
+    };
+}
+
+TEST_CASE("atomic_box") {
+    tracked::alive = 0;
+
+    {
+        auto domain = ben::epoch_domain(0);
+        auto published = ben::atomic_box<tracked>(domain);
+
+        SECTION("load and store") {
+            REQUIRE(!published.load());
+            REQUIRE(published.is_lock_free());
+
+            published.store(ben::box<tracked>(tracked(1)));
+            auto guard = published.load();
+
+            REQUIRE(guard.has_value());
+            REQUIRE(guard->value == 1);
+
+            published.store(ben::box<tracked>(tracked(2)));
+            domain.collect();
+            domain.collect();
+
+            // The guard still sees the value it loaded, which is kept alive.
+            REQUIRE((*guard).value == 1);
+            REQUIRE(published.load().value().value == 2);
+            REQUIRE(tracked::alive == 2);
+        }
+
+        SECTION("exchange") {
+            published.store(ben::box<tracked>(tracked(1)));
+
+            auto old = published.exchange(ben::box<tracked>(tracked(2)));
+
+            REQUIRE(old.value().value == 1);
+            REQUIRE(published.load()->value == 2);
+
+            auto empty = ben::atomic_box<tracked>(domain);
+            REQUIRE(!empty.exchange(ben::box<tracked>()).has_value());
+        }
+
+        SECTION("compare_exchange") {
+            published.store(ben::box<tracked>(tracked(1)));
+
+            auto desired = ben::box<tracked>(tracked(2));
+            auto stale = published.load();
+            {
+                auto current = published.load();
+                REQUIRE(published.compare_exchange(current, desired));
+            }
+
+            REQUIRE(!desired.has_value());
+            REQUIRE(published.load()->value == 2);
+
+            desired = ben::box<tracked>(tracked(3));
+            REQUIRE(!published.compare_exchange(stale, desired));
+            REQUIRE(desired.value().value == 3);
+            REQUIRE(published.load()->value == 2);
+        }
+    }
+
+    REQUIRE(tracked::alive == 0);
+}
+
+TEST_CASE("atomic_box readers and writers") {
+    tracked::alive = 0;
+
+    {
+        auto domain = ben::epoch_domain();
+        auto published = ben::atomic_box<tracked>(ben::box<tracked>(tracked(0)), domain);
+        auto done = std::atomic<bool>(false);
+        auto mismatches = std::atomic<int>(0);
+        auto threads = std::vector<std::thread>();
+
+        // Catch's assertions are not thread-safe, so mismatches are only counted on the worker threads.
+        for (auto i = 0; i < 4; ++i) {
+            threads.emplace_back([&] {
+                while (!done) {
+                    auto guard = published.load();
+
+                    if (!guard || guard->value != -guard->negated) {
+                        ++mismatches;
+                    }
+                }
+            });
+        }
+
+        for (auto i = 0; i < 2; ++i) {
+            threads.emplace_back([&, i] {
+                for (long j = 1; j <= 2000; ++j) {
+                    if (j % 2 == i) {
+                        published.store(ben::box<tracked>(tracked(j)));
+                    } else {
+                        auto current = published.load();
+                        auto desired = ben::box<tracked>(tracked(current->value + 1));
+                        published.compare_exchange(current, desired);
+                    }
+                }
+            });
+        }
+
+        threads[4].join();
+        threads[5].join();
+        done = true;
+
+        for (auto i = 0; i < 4; ++i) {
+            threads[i].join();
+        }
+
+        REQUIRE(mismatches == 0);
+    }
+
+    REQUIRE(tracked::alive == 0);
+}
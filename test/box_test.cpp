@@ -1,9 +1,14 @@
 #include "box.hpp"
+#include "counting_allocator.hpp"
 #include <catch2/catch.hpp>
 
+#include <memory>
+#include <optional>
 #include <string_view>
 #include <string>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
 template <typename T>
 static void value_check(ben::box<T> const& box) {
@@ -173,3 +178,639 @@ TEST_CASE("Iterators") {
     REQUIRE(box.begin() + 1 == box.end());
     REQUIRE(box.cbegin() + 1 == box.cend());
 }
+
+template <typename T>
+struct stateful_allocator : std::allocator<T> {
+    int id = 0;
+
+    stateful_allocator() = default;
+    explicit stateful_allocator(int id) : id(id) {}
+
+    template <typename U>
+    stateful_allocator(stateful_allocator<U> const& other) : id(other.id) {}
+
+    template <typename U>
+    struct rebind {
+        using other = stateful_allocator<U>;
+    };
+
+    using is_always_equal = std::false_type;
+    using propagate_on_container_move_assignment = std::false_type;
+
+    friend auto operator==(stateful_allocator const& a, stateful_allocator const& b) -> bool {
+        return a.id == b.id;
+    }
+
+    friend auto operator!=(stateful_allocator const& a, stateful_allocator const& b) -> bool {
+        return !(a == b);
+    }
+};
+
+struct flag_policy : ben::default_box_policy {
+    using layout = ben::flag_layout;
+};
+
+TEST_CASE("Layout") {
+    SECTION("Stateless allocators take up no space") {
+        static_assert(sizeof(ben::box<int, std::allocator<int>, flag_policy>) == sizeof(std::pair<int*, bool>));
+        static_assert(sizeof(ben::box<char>) == sizeof(std::pair<char*, bool>));
+    }
+
+    SECTION("Tagged pointers fit a single word") {
+        static_assert(sizeof(ben::box<int>) == sizeof(int*));
+        static_assert(sizeof(ben::box<std::string>) == sizeof(std::string*));
+
+        auto box = ben::box(std::string("tagged"));
+        value_check(box);
+        REQUIRE(box.value() == "tagged");
+
+        box.erase();
+        REQUIRE(!box.has_value());
+        REQUIRE(box.begin() == box.end());
+
+        box.emplace("retagged");
+        value_check(box);
+        REQUIRE(box.value() == "retagged");
+
+        auto other = ben::box<std::string>();
+        swap(box, other);
+        REQUIRE(!box.has_value());
+        value_check(other);
+        REQUIRE(other.value() == "retagged");
+    }
+
+    SECTION("Flag layout") {
+        auto box = ben::box<int, std::allocator<int>, flag_policy>(5);
+
+        REQUIRE(box.has_value());
+        REQUIRE(box.value() == 5);
+
+        box.erase();
+        REQUIRE(!box.has_value());
+
+        box.push(3);
+        REQUIRE(box.value() == 3);
+    }
+
+    SECTION("Stateful allocators are stored") {
+        static_assert(sizeof(ben::box<int, stateful_allocator<int>>) > sizeof(ben::box<int>));
+
+        auto box = ben::box<int, stateful_allocator<int>>(5, stateful_allocator<int>(3));
+
+        REQUIRE(box.value() == 5);
+        REQUIRE(box.get_allocator().id == 3);
+
+        // The allocator does not propagate on copy assignment.
+        auto other = ben::box<int, stateful_allocator<int>>(stateful_allocator<int>(4));
+        other = box;
+
+        REQUIRE(other.value() == 5);
+        REQUIRE(other.get_allocator().id == 4);
+    }
+}
+
+struct copy_counter {
+    static inline int copies = 0;
+
+    int value = 0;
+
+    copy_counter(int value) : value(value) {}
+    copy_counter(copy_counter const& other) : value(other.value) {
+        ++copies;
+    }
+
+    copy_counter(copy_counter&&) = default;
+
+    auto operator=(copy_counter const& other) -> copy_counter& {
+        value = other.value;
+        ++copies;
+        return *this;
+    }
+
+    auto operator=(copy_counter&&) -> copy_counter& = default;
+};
+
+TEST_CASE("noexcept") {
+    SECTION("Type traits") {
+        using box = ben::box<std::string>;
+
+        static_assert(std::is_nothrow_default_constructible_v<box>);
+        static_assert(std::is_nothrow_move_constructible_v<box>);
+        static_assert(std::is_nothrow_move_assignable_v<box>);
+        static_assert(std::is_nothrow_swappable_v<box>);
+        static_assert(std::is_nothrow_destructible_v<box>);
+
+        using stateful_box = ben::box<std::string, stateful_allocator<std::string>>;
+
+        static_assert(std::is_nothrow_move_constructible_v<stateful_box>);
+        static_assert(!std::is_nothrow_move_assignable_v<stateful_box>);
+    }
+
+    SECTION("Vector growth does not copy") {
+        copy_counter::copies = 0;
+
+        auto boxes = std::vector<ben::box<copy_counter>>();
+        for (int i = 0; i < 100; ++i) {
+            boxes.push_back(ben::box(copy_counter(i)));
+        }
+
+        REQUIRE(copy_counter::copies == 0);
+        for (int i = 0; i < 100; ++i) {
+            REQUIRE(boxes[i].value().value == i);
+        }
+
+        boxes.reserve(boxes.capacity() * 2);
+        boxes.insert(boxes.begin(), ben::box(copy_counter(-1)));
+
+        REQUIRE(copy_counter::copies == 0);
+        REQUIRE(boxes.front().value().value == -1);
+    }
+
+    SECTION("Moving between boxes with unequal allocators") {
+        auto box = ben::box<int, stateful_allocator<int>>(5, stateful_allocator<int>(1));
+        auto other = ben::box<int, stateful_allocator<int>>(stateful_allocator<int>(2));
+
+        other = std::move(box);
+
+        REQUIRE(other.value() == 5);
+        REQUIRE(other.get_allocator().id == 2);
+
+        auto moved = std::move(other);
+
+        REQUIRE(moved.value() == 5);
+        REQUIRE(moved.get_allocator().id == 2);
+        REQUIRE(!other.has_value());
+    }
+}
+
+struct operation_counter {
+    static inline int constructions = 0;
+    static inline int assignments = 0;
+
+    int value = 0;
+
+    operation_counter(int value) : value(value) {
+        ++constructions;
+    }
+
+    operation_counter(operation_counter const& other) : value(other.value) {
+        ++constructions;
+    }
+
+    auto operator=(operation_counter const& other) -> operation_counter& {
+        value = other.value;
+        ++assignments;
+        return *this;
+    }
+
+    static void reset() {
+        constructions = 0;
+        assignments = 0;
+    }
+};
+
+struct throws_on_negative {
+    int value = 0;
+
+    throws_on_negative(int value) : value(value) {
+        if (value < 0) {
+            throw value;
+        }
+    }
+};
+
+struct not_assignable {
+    int const value = 0;
+
+    not_assignable(int value) : value(value) {}
+};
+
+// Constructing it cannot throw, but destroying it frees what an argument might refer to.
+struct owns_int {
+    std::unique_ptr<int> value;
+
+    owns_int(int value) noexcept : value(std::make_unique<int>(value)) {}
+};
+
+template <typename Strategy>
+struct emplace_policy : ben::default_box_policy {
+    using emplace_strategy = Strategy;
+};
+
+template <typename T, typename Strategy>
+using strategy_box = ben::box<T, std::allocator<T>, emplace_policy<Strategy>>;
+
+TEST_CASE("Emplace strategies") {
+    SECTION("assign_emplace") {
+        auto box = strategy_box<operation_counter, ben::assign_emplace>(1);
+        operation_counter::reset();
+
+        box.emplace(2);
+
+        REQUIRE(box.value().value == 2);
+        REQUIRE(operation_counter::constructions == 1);
+        REQUIRE(operation_counter::assignments == 1);
+
+        box.push(operation_counter(3));
+
+        REQUIRE(box.value().value == 3);
+        REQUIRE(operation_counter::constructions == 2);
+        REQUIRE(operation_counter::assignments == 2);
+    }
+
+    SECTION("reconstruct_emplace") {
+        auto box = strategy_box<operation_counter, ben::reconstruct_emplace>(1);
+        auto address = &box.value();
+        operation_counter::reset();
+
+        box.emplace(2);
+
+        REQUIRE(box.value().value == 2);
+        REQUIRE(&box.value() == address);
+        REQUIRE(operation_counter::constructions == 1);
+        REQUIRE(operation_counter::assignments == 0);
+    }
+
+    SECTION("adaptive_emplace") {
+        auto box = ben::box<operation_counter>(1);
+        auto other = operation_counter(2);
+        operation_counter::reset();
+
+        // Elements of the same type are assigned directly.
+        box.push(other);
+
+        REQUIRE(box.value().value == 2);
+        REQUIRE(operation_counter::constructions == 0);
+        REQUIRE(operation_counter::assignments == 1);
+
+        // Constructing from anything else may throw, so a temporary is assigned.
+        box.emplace(3);
+
+        REQUIRE(box.value().value == 3);
+        REQUIRE(operation_counter::constructions == 1);
+        REQUIRE(operation_counter::assignments == 2);
+
+        auto ints = ben::box<int>(1);
+        ints.emplace(2);
+        REQUIRE(ints.value() == 2);
+    }
+
+    SECTION("Types that are not assignable") {
+        auto box = ben::box<not_assignable>(1);
+        box.emplace(2);
+
+        REQUIRE(box.value().value == 2);
+
+        auto reconstructing = strategy_box<not_assignable, ben::reconstruct_emplace>(1);
+        reconstructing.emplace(3);
+
+        REQUIRE(reconstructing.value().value == 3);
+    }
+
+    SECTION("Arguments that refer to the element") {
+        auto box = ben::box<std::optional<std::string>>(std::string(100, 'x'));
+        box.emplace(std::move(*box.value()));
+
+        REQUIRE(box.value() == std::string(100, 'x'));
+
+        auto owner = ben::box<owns_int>(7);
+        owner.emplace(*owner.value().value);
+
+        REQUIRE(*owner.value().value == 7);
+    }
+
+    SECTION("Exception safety") {
+        auto assigning = strategy_box<throws_on_negative, ben::assign_emplace>(1);
+
+        REQUIRE_THROWS(assigning.emplace(-1));
+        REQUIRE(assigning.has_value());
+        REQUIRE(assigning.value().value == 1);
+
+        auto reconstructing = strategy_box<throws_on_negative, ben::reconstruct_emplace>(1);
+        auto address = &reconstructing.value();
+
+        REQUIRE_THROWS(reconstructing.emplace(-1));
+        REQUIRE(!reconstructing.has_value());
+
+        reconstructing.emplace(2);
+        REQUIRE(reconstructing.value().value == 2);
+        REQUIRE(&reconstructing.value() == address);
+    }
+}
+
+namespace {
+    using counted = ben::counting_allocator<std::string>;
+    using counted_box = ben::box<std::string, counted>;
+
+    auto take_stats() -> ben::allocation_stats {
+        auto stats = counted::stats();
+        counted::reset_stats();
+        return stats;
+    }
+}
+
+TEST_CASE("Allocation counts") {
+    counted::reset_stats();
+
+    SECTION("Construction and destruction") {
+        {
+            auto empty = counted_box();
+            auto b = counted_box("foo");
+            auto stats = take_stats();
+
+            REQUIRE(stats.allocations == 1);
+            REQUIRE(stats.constructions == 1);
+            REQUIRE(stats.bytes_allocated == sizeof(std::string));
+        }
+
+        auto stats = take_stats();
+
+        REQUIRE(stats.deallocations == 1);
+        REQUIRE(stats.destructions == 1);
+        REQUIRE(stats.bytes_deallocated == sizeof(std::string));
+    }
+
+    SECTION("Copy construction") {
+        auto b = counted_box("foo");
+        take_stats();
+
+        auto copy = b;
+        auto stats = take_stats();
+
+        REQUIRE(stats.allocations == 1);
+        REQUIRE(stats.constructions == 1);
+    }
+
+    SECTION("Copy assignment into a box with a value reuses its storage") {
+        auto a = counted_box("foo");
+        auto b = counted_box("bar");
+        take_stats();
+
+        a = b;
+        auto stats = take_stats();
+
+        REQUIRE(a.value() == "bar");
+        REQUIRE(stats.allocations == 0);
+        REQUIRE(stats.deallocations == 0);
+        REQUIRE(stats.constructions == 0);
+        REQUIRE(stats.destructions == 0);
+    }
+
+    SECTION("Copy assignment into an erased box reuses its storage") {
+        auto a = counted_box("foo");
+        auto b = counted_box("bar");
+        a.erase();
+        take_stats();
+
+        a = b;
+        auto stats = take_stats();
+
+        REQUIRE(a.value() == "bar");
+        REQUIRE(stats.allocations == 0);
+        REQUIRE(stats.constructions == 1);
+    }
+
+    SECTION("Copy assignment of an empty box keeps the storage") {
+        auto a = counted_box("foo");
+        auto empty = counted_box();
+        take_stats();
+
+        a = empty;
+        auto stats = take_stats();
+
+        REQUIRE(!a.has_value());
+        REQUIRE(stats.deallocations == 0);
+        REQUIRE(stats.destructions == 1);
+    }
+
+    SECTION("Moves never allocate") {
+        auto a = counted_box("foo");
+        take_stats();
+
+        auto b = std::move(a);
+        a = std::move(b);
+        auto stats = take_stats();
+
+        REQUIRE(stats.allocations == 0);
+        REQUIRE(stats.constructions == 0);
+        REQUIRE(stats.deallocations == 0);
+    }
+
+    SECTION("Move assignment releases the old storage") {
+        auto a = counted_box("foo");
+        auto b = counted_box("bar");
+        take_stats();
+
+        a = std::move(b);
+        auto stats = take_stats();
+
+        REQUIRE(stats.allocations == 0);
+        REQUIRE(stats.deallocations == 1);
+        REQUIRE(stats.destructions == 1);
+    }
+
+    SECTION("Erase followed by push reuses the storage") {
+        auto b = counted_box("foo");
+        auto address = &b.value();
+        take_stats();
+
+        b.erase();
+        b.push("bar");
+        auto stats = take_stats();
+
+        REQUIRE(&b.value() == address);
+        REQUIRE(stats.allocations == 0);
+        REQUIRE(stats.deallocations == 0);
+        REQUIRE(stats.destructions == 1);
+        REQUIRE(stats.constructions == 1);
+    }
+
+    SECTION("Emplace over an existing value does not allocate") {
+        auto b = counted_box("foo");
+        take_stats();
+
+        b.emplace(3, 'x');
+        b.push(std::string("bar"));
+        auto stats = take_stats();
+
+        REQUIRE(b.value() == "bar");
+        REQUIRE(stats.allocations == 0);
+        REQUIRE(stats.deallocations == 0);
+    }
+
+    SECTION("Swap does not allocate") {
+        auto a = counted_box("foo");
+        auto b = counted_box();
+        take_stats();
+
+        swap(a, b);
+        auto stats = take_stats();
+
+        REQUIRE(b.value() == "foo");
+        REQUIRE(stats.allocations == 0);
+        REQUIRE(stats.constructions == 0);
+    }
+
+    counted::reset_stats();
+}
+
+struct releasing_policy : ben::default_box_policy {
+    using storage_strategy = ben::release_storage;
+};
+
+using releasing_box = ben::box<std::string, counted, releasing_policy>;
+
+TEST_CASE("Storage") {
+    counted::reset_stats();
+
+    SECTION("capacity") {
+        auto b = counted_box();
+        REQUIRE(b.capacity() == 0);
+
+        b.push("foo");
+        REQUIRE(b.capacity() == 1);
+
+        b.erase();
+        REQUIRE(b.capacity() == 1);
+    }
+
+    SECTION("reserve") {
+        auto b = counted_box();
+        take_stats();
+
+        b.reserve();
+        b.reserve();
+
+        REQUIRE(!b.has_value());
+        REQUIRE(b.capacity() == 1);
+        REQUIRE(take_stats().allocations == 1);
+
+        b.push("foo");
+        auto stats = take_stats();
+
+        REQUIRE(b.value() == "foo");
+        REQUIRE(stats.allocations == 0);
+        REQUIRE(stats.constructions == 1);
+    }
+
+    SECTION("shrink_to_fit") {
+        auto b = counted_box("foo");
+        take_stats();
+
+        b.shrink_to_fit();
+        REQUIRE(b.value() == "foo");
+        REQUIRE(take_stats().deallocations == 0);
+
+        b.erase();
+        b.shrink_to_fit();
+
+        REQUIRE(b.capacity() == 0);
+        REQUIRE(take_stats().deallocations == 1);
+
+        b.push("bar");
+        REQUIRE(b.value() == "bar");
+    }
+
+    SECTION("reset") {
+        auto b = counted_box("foo");
+        take_stats();
+
+        b.reset();
+        auto stats = take_stats();
+
+        REQUIRE(!b.has_value());
+        REQUIRE(b.capacity() == 0);
+        REQUIRE(stats.destructions == 1);
+        REQUIRE(stats.deallocations == 1);
+
+        b.reset();
+        REQUIRE(take_stats().deallocations == 0);
+    }
+
+    SECTION("release_storage") {
+        auto b = releasing_box("foo");
+        take_stats();
+
+        b.erase();
+        auto stats = take_stats();
+
+        REQUIRE(b.capacity() == 0);
+        REQUIRE(stats.destructions == 1);
+        REQUIRE(stats.deallocations == 1);
+
+        b.push("bar");
+        REQUIRE(b.value() == "bar");
+        REQUIRE(take_stats().allocations == 1);
+
+        // Replacing an element still reuses the storage.
+        b.emplace(3, 'x');
+        b = releasing_box("baz");
+        REQUIRE(b.value() == "baz");
+
+        auto empty = releasing_box();
+        b = empty;
+
+        REQUIRE(b.capacity() == 0);
+    }
+
+    counted::reset_stats();
+}
+
+TEST_CASE("unique_ptr interop") {
+    SECTION("Adopting a unique_ptr") {
+        auto unique = std::make_unique<std::string>("adopted");
+        auto address = unique.get();
+
+        auto box = ben::box<std::string>(std::move(unique));
+
+        value_check(box);
+        REQUIRE(unique == nullptr);
+        REQUIRE(&box.value() == address);
+
+        auto empty = ben::box<std::string>(std::unique_ptr<std::string>());
+        REQUIRE(!empty.has_value());
+    }
+
+    SECTION("Handing over to a unique_ptr") {
+        auto box = ben::box<std::string>(std::string("released"));
+        auto address = &box.value();
+
+        auto unique = std::move(box).into_unique();
+
+        REQUIRE(unique.get() == address);
+        REQUIRE(*unique == "released");
+        REQUIRE(!box.has_value());
+        REQUIRE(box.capacity() == 0);
+    }
+
+    SECTION("Releasing and adopting with an allocator") {
+        auto box = counted_box(std::string("raw"));
+        auto alloc = box.get_allocator();
+        take_stats();
+
+        auto ptr = box.release();
+        REQUIRE(!box.has_value());
+        REQUIRE(box.capacity() == 0);
+
+        auto adopted = ben::from_raw(ptr, alloc);
+        static_assert(std::is_same_v<decltype(adopted), counted_box>);
+        REQUIRE(adopted.value() == "raw");
+
+        auto stats = take_stats();
+        REQUIRE(stats.allocations == 0);
+        REQUIRE(stats.constructions == 0);
+    }
+
+    struct base {
+        virtual ~base() = default;
+    };
+
+    struct leaf final : base {};
+
+    static_assert(std::is_constructible_v<ben::box<int>, std::unique_ptr<int>&&>);
+    static_assert(std::is_constructible_v<ben::box<leaf>, std::unique_ptr<leaf>&&>);
+    static_assert(!std::is_constructible_v<ben::box<base>, std::unique_ptr<base>&&>);
+    static_assert(!std::is_constructible_v<ben::pmr::box<int>, std::unique_ptr<int>&&>);
+
+    counted::reset_stats();
+}
@@ -0,0 +1,99 @@
+#include "arena_allocator.hpp"
+#include "compact.hpp"
+#include <catch2/catch.hpp>
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace {
+    template <typename T>
+    using arena_box = ben::box<T, ben::arena_allocator<T>>;
+
+    struct point {
+        long x;
+        long y;
+    };
+
+    // An arena for allocators that do release single elements, backed by the standard allocator.
+    struct heap_arena {
+        int allocators = 0;
+    };
+
+    template <typename T>
+    struct heap_allocator : std::allocator<T> {
+        template <typename U>
+        struct rebind {
+            using other = heap_allocator<U>;
+        };
+
+        heap_allocator() = default;
+
+        explicit heap_allocator(heap_arena& a) {
+            ++a.allocators;
+        }
+
+        template <typename U>
+        heap_allocator(heap_allocator<U> const&) {}
+    };
+}
+
+TEST_CASE("compact") {
+    auto scattered = ben::arena(64);
+    auto churn = ben::arena(64);
+    auto boxes = std::vector<arena_box<point>>();
+
+    for (long i = 0; i < 100; ++i) {
+        boxes.emplace_back(point{i, -i}, ben::arena_allocator<point>(scattered));
+        static_cast<void>(churn.allocate(48, 8));
+    }
+
+    boxes[10].erase();
+    std::swap(boxes[0], boxes[99]);
+
+    auto target = ben::arena(1 << 16);
+    ben::compact(boxes.begin(), boxes.end(), target);
+
+    auto previous = static_cast<point const*>(nullptr);
+
+    for (auto const& b : boxes) {
+        if (!b.has_value()) {
+            continue;
+        }
+
+        REQUIRE(b.get_allocator() == ben::arena_allocator<point>(target));
+
+        if (previous != nullptr) {
+            REQUIRE(&b.value() == previous + 1);
+        }
+
+        previous = &b.value();
+    }
+
+    REQUIRE(!boxes[10].has_value());
+    REQUIRE(boxes[0].value().x == 99);
+    REQUIRE(boxes[99].value().y == 0);
+    REQUIRE(boxes[50].value().x == 50);
+
+    // The boxes now allocate from the new arena.
+    boxes[10].emplace(point{1, 1});
+    REQUIRE(boxes[10].get_allocator() == ben::arena_allocator<point>(target));
+}
+
+TEST_CASE("compact with element-wise deallocation") {
+    using box_type = ben::box<std::string, heap_allocator<std::string>>;
+
+    auto arena = heap_arena();
+    auto boxes = std::vector<box_type>();
+
+    for (auto i = 0; i < 10; ++i) {
+        boxes.emplace_back(std::string(40, static_cast<char>('a' + i)));
+    }
+
+    boxes[3].reset();
+    ben::compact(boxes.begin(), boxes.end(), arena);
+
+    REQUIRE(arena.allocators == 1);
+    REQUIRE(!boxes[3].has_value());
+    REQUIRE(boxes[9].value() == std::string(40, 'j'));
+}
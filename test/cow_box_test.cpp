@@ -0,0 +1,225 @@
+#include "counting_allocator.hpp"
+#include "cow_box.hpp"
+#include <catch2/catch.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <memory_resource>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace {
+    using counted = ben::counting_allocator<std::string>;
+
+    template <typename Refcount>
+    using counted_cow_box = ben::cow_box<std::string, Refcount, counted>;
+}
+
+TEMPLATE_TEST_CASE("cow_box", "", ben::nonatomic_refcount, ben::atomic_refcount) {
+    using cow_box = counted_cow_box<TestType>;
+
+    static_assert(std::is_nothrow_move_constructible_v<cow_box>);
+    static_assert(std::is_nothrow_move_assignable_v<cow_box>);
+    static_assert(sizeof(cow_box) == sizeof(void*));
+
+    counted::reset_stats();
+
+    SECTION("Copies share the element") {
+        auto const a = cow_box("foo");
+        auto b = a;
+        auto c = cow_box();
+        c = b;
+
+        REQUIRE(&a.value() == &std::as_const(b).value());
+        REQUIRE(&a.value() == &std::as_const(c).value());
+        REQUIRE(a.use_count() == 3);
+        REQUIRE(counted::stats().allocations == 1);
+        REQUIRE(counted::stats().constructions == 1);
+    }
+
+    SECTION("Mutable access clones a shared element") {
+        auto const a = cow_box("foo");
+        auto b = a;
+
+        b.value() += "bar";
+
+        REQUIRE(a.value() == "foo");
+        REQUIRE(b.value() == "foobar");
+        REQUIRE(a.use_count() == 1);
+        REQUIRE(b.use_count() == 1);
+        REQUIRE(counted::stats().allocations == 2);
+
+        // Now that it is no longer shared, the element is modified in place.
+        auto address = &b.value();
+        *b += "baz";
+        *b.begin() += "!";
+
+        REQUIRE(b.value() == "foobarbaz!");
+        REQUIRE(&b.value() == address);
+        REQUIRE(counted::stats().allocations == 2);
+    }
+
+    SECTION("Read-only access never clones") {
+        auto a = cow_box("foo");
+        auto const b = a;
+
+        REQUIRE(*b == "foo");
+        REQUIRE(b.safe_value()->get() == "foo");
+        REQUIRE(b.begin() + 1 == b.end());
+        REQUIRE(a.cbegin() == b.cbegin());
+        REQUIRE(a.use_count() == 2);
+    }
+
+    SECTION("Dropping the last reference frees the element") {
+        {
+            auto a = cow_box("foo");
+            auto b = a;
+
+            a.erase();
+
+            REQUIRE(!a.has_value());
+            REQUIRE(a.use_count() == 0);
+            REQUIRE(b.use_count() == 1);
+            REQUIRE(counted::stats().deallocations == 0);
+        }
+
+        REQUIRE(counted::stats().deallocations == 1);
+        REQUIRE(counted::stats().destructions == 1);
+    }
+
+    SECTION("Replacing a shared element leaves the other copies alone") {
+        auto a = cow_box("foo");
+        auto b = a;
+
+        b.push("bar");
+        a.emplace(3, 'x');
+
+        REQUIRE(a.value() == "xxx");
+        REQUIRE(b.value() == "bar");
+        REQUIRE(counted::stats().allocations == 2);
+    }
+
+    SECTION("Replacing an element that is not shared reuses its storage") {
+        auto a = cow_box("foo");
+        auto address = &a.value();
+
+        a.push(std::string("bar"));
+
+        REQUIRE(a.value() == "bar");
+        REQUIRE(&a.value() == address);
+        REQUIRE(counted::stats().allocations == 1);
+    }
+
+    SECTION("Moves") {
+        auto a = cow_box("foo");
+        auto b = a;
+        auto c = std::move(a);
+
+        REQUIRE(!a.has_value());
+        REQUIRE(c.use_count() == 2);
+
+        a = std::move(c);
+
+        REQUIRE(std::as_const(a).value() == "foo");
+        REQUIRE(!c.has_value());
+        REQUIRE(counted::stats().allocations == 1);
+    }
+
+    SECTION("swap") {
+        auto a = cow_box("foo");
+        auto b = cow_box();
+
+        swap(a, b);
+
+        REQUIRE(!a.has_value());
+        REQUIRE(b.value() == "foo");
+    }
+
+    counted::reset_stats();
+}
+
+namespace {
+    // Not assignable, so that replacing an element that is not shared reconstructs it.
+    struct throws_on_negative {
+        int const value = 0;
+
+        throws_on_negative(int value) : value(value) {
+            if (value < 0) {
+                throw value;
+            }
+        }
+    };
+}
+
+TEST_CASE("cow_box with a throwing constructor") {
+    using allocator = ben::counting_allocator<throws_on_negative>;
+    allocator::reset_stats();
+
+    {
+        auto b = ben::cow_box<throws_on_negative, ben::nonatomic_refcount, allocator>(1);
+
+        REQUIRE_THROWS(b.emplace(-1));
+        REQUIRE(!b.has_value());
+        REQUIRE(allocator::stats().live_allocations() == 0);
+
+        b.emplace(2);
+        REQUIRE(b.value().value == 2);
+    }
+
+    REQUIRE(allocator::stats().live_allocations() == 0);
+    REQUIRE(allocator::stats().constructions == allocator::stats().destructions);
+}
+
+TEST_CASE("cow_box with unequal allocators") {
+    std::pmr::monotonic_buffer_resource first;
+    std::pmr::monotonic_buffer_resource second;
+
+    using cow_box = ben::cow_box<std::pmr::string, ben::nonatomic_refcount,
+                                 std::pmr::polymorphic_allocator<std::pmr::string>>;
+
+    auto a = cow_box(std::pmr::string("foo"), &first);
+    auto b = cow_box(&second);
+
+    b = a;
+
+    REQUIRE(b.value() == "foo");
+    REQUIRE(a.use_count() == 1);
+    REQUIRE(b.get_allocator().resource() == &second);
+
+    auto c = cow_box(&first);
+    c = a;
+
+    REQUIRE(a.use_count() == 2);
+}
+
+TEST_CASE("cow_box with atomic_refcount shared between threads") {
+    auto const original = ben::cow_box<std::vector<int>>(std::vector<int>(64, 1));
+    auto mismatches = std::atomic<int>(0);
+    auto threads = std::vector<std::thread>();
+
+    for (auto i = 0; i < 4; ++i) {
+        threads.emplace_back([copy = original, &mismatches]() mutable {
+            for (auto j = 0; j < 1000; ++j) {
+                auto snapshot = copy;
+                auto const& values = std::as_const(snapshot).value();
+
+                if (values.size() != 64 || values.front() != 1) {
+                    ++mismatches;
+                }
+
+                snapshot.value().push_back(j);
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    REQUIRE(mismatches == 0);
+    REQUIRE(original.use_count() == 1);
+    REQUIRE(original.value().size() == 64);
+}
@@ -0,0 +1,184 @@
+#include "counting_allocator.hpp"
+#include "epoch.hpp"
+#include <catch2/catch.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+    void set_flag(void* ptr) noexcept {
+        static_cast<std::atomic<bool>*>(ptr)->store(true);
+    }
+
+    using counted = ben::counting_allocator<std::string>;
+
+    // Compares equal to every other instance, but is not known to be always equal.
+    template <typename T>
+    struct stateful_allocator : std::allocator<T> {
+        using is_always_equal = std::false_type;
+
+        template <typename U>
+        struct rebind {
+            using other = stateful_allocator<U>;
+        };
+
+        stateful_allocator() = default;
+
+        template <typename U>
+        stateful_allocator(stateful_allocator<U> const&) noexcept {}
+    };
+}
+
+TEST_CASE("epoch_domain") {
+    auto domain = ben::epoch_domain(0);
+    auto deleted = std::atomic<bool>(false);
+
+    SECTION("Without readers, collect destroys everything retired before") {
+        domain.retire(&deleted, &set_flag);
+
+        REQUIRE(domain.pending() == 1);
+        REQUIRE(domain.collect() == 1);
+        REQUIRE(deleted);
+        REQUIRE(domain.pending() == 0);
+    }
+
+    SECTION("Retired objects are kept alive for guards") {
+        {
+            auto guard = domain.pin();
+            domain.retire(&deleted, &set_flag);
+
+            domain.collect();
+            domain.collect();
+            domain.collect();
+
+            REQUIRE(!deleted);
+        }
+
+        domain.collect();
+        REQUIRE(deleted);
+    }
+
+    SECTION("Guards nest") {
+        auto outer = domain.pin();
+
+        {
+            auto inner = domain.pin();
+        }
+
+        domain.retire(&deleted, &set_flag);
+        domain.collect();
+
+        REQUIRE(!deleted);
+    }
+
+    SECTION("Guards of threads that have exited do not hold anything back") {
+        std::thread([&] {
+            auto guard = domain.pin();
+        }).join();
+
+        domain.synchronize();
+        domain.retire(&deleted, &set_flag);
+
+        REQUIRE(domain.collect() == 1);
+    }
+
+    SECTION("Retiring collects once the threshold is reached") {
+        auto eager = ben::epoch_domain(2);
+        auto other = std::atomic<bool>(false);
+
+        eager.retire(&deleted, &set_flag);
+        REQUIRE(!deleted);
+
+        eager.retire(&other, &set_flag);
+        REQUIRE(deleted);
+        REQUIRE(other);
+    }
+
+    SECTION("The destructor destroys everything") {
+        {
+            auto local = ben::epoch_domain(0);
+            local.retire(&deleted, &set_flag);
+        }
+
+        REQUIRE(deleted);
+    }
+}
+
+TEST_CASE("Retiring boxes") {
+    auto domain = ben::epoch_domain(0);
+    counted::reset_stats();
+
+    SECTION("Boxes are destroyed in collect") {
+        auto b = ben::box<std::string, counted>("A string long enough to need memory of its own.");
+
+        domain.retire(std::move(b));
+
+        REQUIRE(!b.has_value());
+        REQUIRE(b.capacity() == 0);
+        REQUIRE(counted::stats().destructions == 0);
+        REQUIRE(counted::stats().deallocations == 0);
+
+        domain.collect();
+
+        REQUIRE(counted::stats().destructions == 1);
+        REQUIRE(counted::stats().deallocations == 1);
+    }
+
+    SECTION("Retiring an always equal allocator does not allocate") {
+        auto b = ben::box<std::string, counted>("foo");
+        auto allocations = counted::stats().allocations;
+
+        domain.retire(std::move(b));
+        domain.collect();
+
+        REQUIRE(counted::stats().allocations == allocations);
+    }
+
+    SECTION("Other allocators") {
+        auto b = ben::box<std::string, stateful_allocator<std::string>>("foo");
+        domain.retire(std::move(b));
+
+        REQUIRE(!b.has_value());
+        REQUIRE(domain.collect() == 1);
+    }
+
+    SECTION("Empty boxes give back their storage right away") {
+        auto b = ben::box<std::string, counted>("foo");
+        b.erase();
+
+        domain.retire(std::move(b));
+
+        REQUIRE(domain.pending() == 0);
+        REQUIRE(counted::stats().deallocations == 1);
+    }
+
+    counted::reset_stats();
+}
+
+TEST_CASE("background_reclaimer") {
+    auto domain = ben::epoch_domain(0);
+    counted::reset_stats();
+
+    {
+        auto reclaimer = ben::background_reclaimer(domain, std::chrono::hours(1));
+
+        for (auto i = 0; i < 100; ++i) {
+            domain.retire(ben::box<std::string, counted>("foo"));
+        }
+
+        reclaimer.wake();
+
+        for (auto tries = 0; domain.pending() != 0 && tries < 1000; ++tries) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        REQUIRE(domain.pending() == 0);
+    }
+
+    REQUIRE(counted::stats().destructions == 100);
+    counted::reset_stats();
+}
@@ -0,0 +1,214 @@
+#include "box.hpp"
+#include "hashed_box.hpp"
+#include <catch2/catch.hpp>
+
+#include <functional>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+namespace {
+    // Counts how often elements are hashed.
+    struct counting_hash {
+        static inline int calls = 0;
+
+        auto operator()(std::string const& s) const -> std::size_t {
+            ++calls;
+            return std::hash<std::string>()(s);
+        }
+    };
+
+    using key = ben::hashed_box<std::string, counting_hash>;
+}
+
+TEST_CASE("box comparison and hashing") {
+    auto empty = ben::box<int>();
+    auto one = ben::box<int>(1);
+    auto two = ben::box<int>(2);
+
+    REQUIRE(one == ben::box<int>(1));
+    REQUIRE(one != two);
+    REQUIRE(empty == ben::box<int>());
+    REQUIRE(empty != one);
+
+    REQUIRE(empty < one);
+    REQUIRE(one < two);
+    REQUIRE(!(one < empty));
+    REQUIRE(two > one);
+    REQUIRE(one <= one);
+    REQUIRE(two >= empty);
+
+    REQUIRE(ben::box<long>(1) == one);
+    REQUIRE(ben::pmr::box<int>(2) == two);
+
+    auto hash = std::hash<ben::box<int>>();
+    REQUIRE(hash(one) == std::hash<int>()(1));
+    REQUIRE(hash(empty) == hash(ben::box<int>()));
+
+    auto counts = std::unordered_map<ben::box<std::string>, int>();
+    counts[ben::box<std::string>(std::string("a"))] += 1;
+    counts[ben::box<std::string>(std::string("a"))] += 1;
+    counts[ben::box<std::string>()] += 1;
+
+    REQUIRE(counts.size() == 2);
+    REQUIRE(counts[ben::box<std::string>(std::string("a"))] == 2);
+
+    auto ordered = std::set<ben::box<int>>{two, empty, one};
+    REQUIRE(*ordered.begin() == empty);
+    REQUIRE(*ordered.rbegin() == two);
+
+    struct unhashable {};
+    static_assert(!std::is_default_constructible_v<std::hash<ben::box<unhashable>>>);
+}
+
+TEST_CASE("hashed_box") {
+    counting_hash::calls = 0;
+
+    auto a = key(std::string("apple"));
+    REQUIRE(counting_hash::calls == 1);
+    REQUIRE(a.hash() == std::hash<std::string>()("apple"));
+    REQUIRE(*a == "apple");
+
+    SECTION("hashing and comparing use the cached hash") {
+        auto set = std::unordered_set<key>();
+        set.insert(a);
+        set.insert(key(std::string("banana")));
+        set.insert(key());
+
+        auto probe = key(std::string("apple"));
+        counting_hash::calls = 0;
+
+        REQUIRE(set.count(probe) == 1);
+        REQUIRE(set.count(key()) == 1);
+        REQUIRE(counting_hash::calls == 0);
+        REQUIRE(std::hash<key>()(probe) == probe.hash());
+    }
+
+    SECTION("mutations keep the hash up to date") {
+        a.emplace("pear");
+        REQUIRE(a.hash() == std::hash<std::string>()("pear"));
+
+        a.push(std::string("plum"));
+        REQUIRE(a.hash() == std::hash<std::string>()("plum"));
+
+        auto length = a.modify([](std::string& s) {
+            s += "s";
+            return s.size();
+        });
+
+        REQUIRE(length == 5);
+        REQUIRE(a == key(std::string("plums")));
+
+        a.erase();
+        REQUIRE(a == key());
+        REQUIRE(a.hash() == key().hash());
+
+        a.emplace("fig");
+        a.reset();
+        REQUIRE(!a.has_value());
+        REQUIRE(a.hash() == key().hash());
+    }
+
+    SECTION("copies, moves and boxes") {
+        auto copy = a;
+        REQUIRE(copy == a);
+        REQUIRE(copy.hash() == a.hash());
+
+        auto moved = std::move(copy);
+        REQUIRE(moved == a);
+        REQUIRE(copy == key());
+
+        auto other = key(std::string("kiwi"));
+        swap(moved, other);
+        REQUIRE(*moved == "kiwi");
+        REQUIRE(other == a);
+
+        auto b = other.take_box();
+        REQUIRE(b.value() == "apple");
+        REQUIRE(other == key());
+
+        auto rewrapped = key(std::move(b));
+        REQUIRE(rewrapped == a);
+        REQUIRE(rewrapped < moved);
+    }
+}
+
+namespace {
+    // Not assignable, so that emplacing reconstructs it, and throws for an empty text.
+    struct label {
+        std::string const text;
+
+        label(char const* text) : text(text) {
+            if (this->text.empty()) {
+                throw std::invalid_argument("empty label");
+            }
+        }
+
+        friend auto operator==(label const& a, label const& b) -> bool {
+            return a.text == b.text;
+        }
+    };
+
+    struct label_hash {
+        auto operator()(label const& l) const -> std::size_t {
+            return std::hash<std::string>()(l.text);
+        }
+    };
+
+    // Refuses to hash one particular string.
+    struct picky_hash {
+        auto operator()(std::string const& s) const -> std::size_t {
+            if (s == "poison") {
+                throw std::invalid_argument("unhashable");
+            }
+
+            return std::hash<std::string>()(s);
+        }
+    };
+}
+
+TEST_CASE("hashed_box with throwing operations") {
+    SECTION("a throwing emplace leaves the hash accurate") {
+        auto a = ben::hashed_box<label, label_hash>(label("apple"));
+
+        REQUIRE_THROWS(a.emplace(""));
+        REQUIRE(!a.has_value());
+        REQUIRE(a.hash() == decltype(a)().hash());
+        REQUIRE(a == decltype(a)());
+    }
+
+    SECTION("modify rehashes when the function throws") {
+        auto a = key(std::string("apple"));
+
+        REQUIRE_THROWS(a.modify([](std::string& s) {
+            s = "pear";
+            throw std::runtime_error("after the change");
+        }));
+
+        REQUIRE(a.hash() == std::hash<std::string>()("pear"));
+        REQUIRE(a == key(std::string("pear")));
+    }
+
+    SECTION("elements that cannot be hashed are erased") {
+        using picky_key = ben::hashed_box<std::string, picky_hash>;
+        auto a = picky_key(std::string("apple"));
+
+        REQUIRE_THROWS(a.modify([](std::string& s) { s = "poison"; }));
+        REQUIRE(!a.has_value());
+        REQUIRE(a == picky_key());
+
+        a.emplace("pear");
+        REQUIRE_THROWS(a.modify([](std::string& s) {
+            s = "poison";
+            throw std::runtime_error("after the change");
+        }));
+        REQUIRE(!a.has_value());
+
+        a.push(std::string("plum"));
+        REQUIRE_THROWS(a.push(std::string("poison")));
+        REQUIRE(a == picky_key());
+    }
+}
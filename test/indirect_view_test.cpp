@@ -0,0 +1,71 @@
+#include "box.hpp"
+#include "indirect_view.hpp"
+#include <catch2/catch.hpp>
+
+#include <forward_list>
+#include <iterator>
+#include <numeric>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+TEST_CASE("indirect_view") {
+    auto boxes = std::vector<ben::box<int>>();
+
+    for (auto i = 0; i < 100; ++i) {
+        if (i % 3 == 0) {
+            boxes.emplace_back();
+        } else {
+            boxes.emplace_back(i);
+        }
+    }
+
+    auto expected = 0;
+    for (auto i = 0; i < 100; ++i) {
+        expected += i % 3 == 0 ? 0 : i;
+    }
+
+    SECTION("yields the elements of non-empty boxes") {
+        for (auto distance : {0, 1, 8, 1000}) {
+            auto view = ben::indirect(boxes, distance);
+            REQUIRE(std::accumulate(view.begin(), view.end(), 0) == expected);
+            REQUIRE(std::distance(view.begin(), view.end()) == 66);
+        }
+    }
+
+    SECTION("elements can be modified in place") {
+        for (auto& value : ben::indirect(boxes)) {
+            value = 1;
+        }
+
+        REQUIRE(boxes[1].value() == 1);
+        REQUIRE(!boxes[0].has_value());
+
+        auto const& view = boxes;
+        static_assert(std::is_same_v<decltype(*ben::indirect(view).begin()), int const&>);
+    }
+
+    SECTION("empty ranges and ranges without values") {
+        auto none = std::vector<ben::box<int>>(5);
+        auto view = ben::indirect(none);
+        REQUIRE(view.begin() == view.end());
+
+        auto nothing = std::vector<ben::box<int>>();
+        REQUIRE(ben::indirect(nothing).begin() == ben::indirect(nothing).end());
+    }
+}
+
+TEST_CASE("indirect_view over forward ranges") {
+    auto list = std::forward_list<ben::box<std::string>>();
+    list.emplace_front(std::string("c"));
+    list.emplace_front();
+    list.emplace_front(std::string("a"));
+
+    auto joined = std::string();
+
+    for (auto const& s : ben::indirect(list, 4)) {
+        joined += s;
+    }
+
+    REQUIRE(joined == "ac");
+}
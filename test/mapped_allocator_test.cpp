@@ -0,0 +1,147 @@
+#include "mapped_allocator.hpp"
+#include "box.hpp"
+#include <catch2/catch.hpp>
+
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <unistd.h>
+
+namespace {
+    template <typename T>
+    using mapped_box = ben::box<T, ben::mapped_allocator<T>>;
+
+    struct point {
+        long x;
+        long y;
+    };
+
+    // A file in the temporary directory, removed again at the end of the test.
+    struct temporary_file {
+        std::string path;
+
+        temporary_file() {
+            auto name = std::string("/tmp/box_mapped_XXXXXX");
+            auto fd = ::mkstemp(name.data());
+            REQUIRE(fd != -1);
+            ::close(fd);
+            path = name;
+        }
+
+        ~temporary_file() {
+            ::unlink(path.c_str());
+        }
+    };
+
+    static_assert(std::is_same_v<mapped_box<point>::iterator, ben::offset_ptr<point>>);
+    static_assert(!ben::is_trivially_relocatable_v<mapped_box<point>>);
+}
+
+TEST_CASE("offset_ptr") {
+    long values[4] = {1, 2, 3, 4};
+
+    auto ptr = ben::offset_ptr<long>(values);
+    auto copy = ptr;
+
+    REQUIRE(ptr.get() == values);
+    REQUIRE(copy.get() == values);
+    REQUIRE(*ptr == 1);
+    REQUIRE(ptr[3] == 4);
+    REQUIRE(*(ptr + 2) == 3);
+    REQUIRE((ptr + 3) - ptr == 3);
+    REQUIRE(++copy > ptr);
+    REQUIRE(*copy == 2);
+
+    auto null = ben::offset_ptr<long>();
+    REQUIRE(null == nullptr);
+    REQUIRE(!null);
+    REQUIRE(null.get() == nullptr);
+    REQUIRE(ptr != nullptr);
+
+    auto erased = ben::offset_ptr<void>(ptr);
+    REQUIRE(static_cast<ben::offset_ptr<long>>(erased) == ptr);
+    REQUIRE(ben::offset_ptr<long>::pointer_to(values[1]) == copy);
+}
+
+TEST_CASE("mapped_allocator") {
+    auto file = temporary_file();
+    auto region = ben::mapped_region::create_file(file.path, 4096);
+
+    SECTION("boxes live in the region") {
+        auto b = mapped_box<point>(point{1, 2}, ben::mapped_allocator<point>(region));
+        auto address = reinterpret_cast<char const*>(&b.value());
+
+        REQUIRE(address >= static_cast<char const*>(region.base()));
+        REQUIRE(address < static_cast<char const*>(region.base()) + region.size());
+
+        auto sum = long(0);
+
+        for (auto& p : b) {
+            sum += p.x + p.y;
+        }
+
+        REQUIRE(sum == 3);
+
+        b.emplace(point{3, 4});
+        REQUIRE(b.value().y == 4);
+
+        auto copy = b;
+        REQUIRE(copy.value().x == 3);
+        REQUIRE(copy.get_allocator() == b.get_allocator());
+        REQUIRE(ben::mapped_allocator<long>(region) == b.get_allocator());
+    }
+
+    SECTION("regions can be mapped at different addresses") {
+        auto shared = static_cast<mapped_box<point>*>(region.allocate(sizeof(mapped_box<point>),
+                                                                      alignof(mapped_box<point>)));
+        new (shared) mapped_box<point>(point{5, 6}, ben::mapped_allocator<point>(region));
+        region.set_root(shared);
+
+        auto other = ben::mapped_region::open_file(file.path);
+        REQUIRE(other.base() != region.base());
+
+        auto seen = other.root<mapped_box<point>>();
+        REQUIRE(seen != shared);
+        REQUIRE(seen->has_value());
+        REQUIRE(seen->value().x == 5);
+        REQUIRE(seen->value().y == 6);
+
+        // Changes made through one mapping are visible through the other, as is memory allocated through it.
+        seen->emplace(point{7, 8});
+        REQUIRE(shared->value().x == 7);
+        REQUIRE(other.used() == region.used());
+
+        std::destroy_at(shared);
+    }
+
+    SECTION("running out of space") {
+        auto alloc = ben::mapped_allocator<point>(region);
+        REQUIRE_THROWS_AS(alloc.allocate(4096), std::bad_alloc);
+    }
+
+    SECTION("opening something that is not a region") {
+        auto empty = temporary_file();
+        REQUIRE_THROWS(ben::mapped_region::open_file(empty.path));
+        REQUIRE_THROWS_AS(ben::mapped_region::open_file(file.path + ".missing"), std::system_error);
+    }
+}
+
+TEST_CASE("mapped_allocator with shared memory") {
+    auto name = "/box_mapped_test_" + std::to_string(::getpid());
+    auto region = ben::mapped_region::create_shared_memory(name, 4096);
+
+    {
+        auto other = ben::mapped_region::open_shared_memory(name);
+        auto b = static_cast<mapped_box<long>*>(region.allocate(sizeof(mapped_box<long>),
+                                                                alignof(mapped_box<long>)));
+        new (b) mapped_box<long>(42, ben::mapped_allocator<long>(region));
+        region.set_root(b);
+
+        REQUIRE(**other.root<mapped_box<long>>() == 42);
+        std::destroy_at(b);
+    }
+
+    ben::mapped_region::remove_shared_memory(name);
+}
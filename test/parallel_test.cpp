@@ -0,0 +1,110 @@
+#include "box.hpp"
+#include "parallel.hpp"
+#include "pool_allocator.hpp"
+#include <catch2/catch.hpp>
+
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+    template <typename T>
+    using pool_box = ben::box<T, ben::pool_allocator<T>>;
+
+    struct fragile {
+        static inline std::atomic<int> alive{0};
+        // While set, copying the element with value 12345 throws.
+        static inline std::atomic<bool> armed{false};
+
+        int value;
+
+        explicit fragile(int value) : value(value) {
+            ++alive;
+        }
+
+        fragile(fragile const& other) : value(other.value) {
+            if (armed && value == 12345) {
+                throw std::runtime_error("copy failed");
+            }
+
+            ++alive;
+        }
+
+        auto operator=(fragile const&) -> fragile& = default;
+
+        ~fragile() {
+            --alive;
+        }
+    };
+}
+
+TEST_CASE("parallel_clone") {
+    auto source = std::vector<pool_box<std::string>>();
+
+    for (auto i = 0; i < 50000; ++i) {
+        source.emplace_back(std::to_string(i));
+    }
+
+    source[7].reset();
+
+    for (auto threads : {0, 1, 3}) {
+        auto copy = std::vector<pool_box<std::string>>(source.size());
+        auto end = ben::parallel_clone(source, copy.begin(), threads);
+
+        REQUIRE(end == copy.end());
+        REQUIRE(!copy[7].has_value());
+
+        auto mismatches = 0;
+        for (auto i = std::size_t(0); i < source.size(); ++i) {
+            if (i != 7 && (copy[i].value() != source[i].value() || &copy[i].value() == &source[i].value())) {
+                ++mismatches;
+            }
+        }
+
+        REQUIRE(mismatches == 0);
+    }
+
+    auto empty = std::vector<ben::box<int>>();
+    REQUIRE(ben::parallel_clone(empty.begin(), empty.end(), empty.begin()) == empty.end());
+}
+
+TEST_CASE("parallel_clone rethrows") {
+    fragile::alive = 0;
+
+    {
+        auto source = std::vector<ben::box<fragile>>();
+
+        for (auto i = 0; i < 20000; ++i) {
+            source.emplace_back(fragile(i == 15000 ? 12345 : i));
+        }
+
+        auto copy = std::vector<ben::box<fragile>>(source.size());
+        fragile::armed = true;
+        REQUIRE_THROWS_AS(ben::parallel_clone(source, copy.begin(), 4), std::runtime_error);
+        fragile::armed = false;
+        REQUIRE(!copy[15000].has_value());
+    }
+
+    REQUIRE(fragile::alive == 0);
+}
+
+TEST_CASE("parallel_destroy") {
+    fragile::alive = 0;
+
+    auto boxes = std::vector<pool_box<fragile>>();
+
+    for (auto i = 0; i < 30000; ++i) {
+        boxes.emplace_back(fragile(i));
+    }
+
+    ben::parallel_destroy(boxes, 4);
+
+    REQUIRE(fragile::alive == 0);
+    REQUIRE(!boxes.front().has_value());
+    REQUIRE(!boxes.back().has_value());
+
+    boxes.front().emplace(1);
+    ben::parallel_destroy(boxes.begin(), boxes.begin() + 1);
+    REQUIRE(fragile::alive == 0);
+}
@@ -0,0 +1,86 @@
+#include "persistent_box.hpp"
+#include <catch2/catch.hpp>
+
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+
+namespace {
+    struct table {
+        long entries[256];
+        ben::offset_ptr<long> extra;
+
+        explicit table(long seed) {
+            for (auto i = 0; i < 256; ++i) {
+                entries[i] = seed + i;
+            }
+        }
+    };
+
+    // A path in the temporary directory that does not exist yet, and is removed at the end of the test.
+    struct temporary_path {
+        std::string path;
+
+        temporary_path() {
+            auto name = std::string("/tmp/box_persistent_XXXXXX");
+            auto fd = ::mkstemp(name.data());
+            REQUIRE(fd != -1);
+            ::close(fd);
+            ::unlink(name.c_str());
+            path = name;
+        }
+
+        ~temporary_path() {
+            ::unlink(path.c_str());
+        }
+    };
+}
+
+TEST_CASE("persistent_box") {
+    auto file = temporary_path();
+
+    {
+        auto persistent = ben::persistent_box<table>::create(file.path, 1 << 16, 3, 10);
+
+        REQUIRE(persistent.has_value());
+        REQUIRE(persistent.version() == 3);
+        REQUIRE(persistent->entries[255] == 265);
+
+        // Objects allocated with the box's allocator live in the file as well.
+        auto alloc = ben::mapped_allocator<long>(persistent.get_allocator());
+        auto extra = alloc.allocate(1);
+        *extra = 42;
+        persistent->extra = extra;
+        persistent.value().entries[0] = -1;
+
+        persistent.flush();
+    }
+
+    SECTION("reopening") {
+        auto persistent = ben::persistent_box<table>::open(file.path, 3);
+
+        REQUIRE(persistent.value().entries[0] == -1);
+        REQUIRE((*persistent).entries[1] == 11);
+        REQUIRE(*persistent->extra == 42);
+
+        persistent.get_box().emplace(20);
+        persistent.flush();
+
+        auto again = ben::persistent_box<table>::open_or_create(file.path, 1 << 16, 3, 30);
+        REQUIRE(again->entries[0] == 20);
+    }
+
+    SECTION("version and type checks") {
+        REQUIRE_THROWS_AS(ben::persistent_box<table>::open(file.path, 4), std::runtime_error);
+        REQUIRE_THROWS_AS(ben::persistent_box<long>::open(file.path, 3), std::runtime_error);
+    }
+
+    SECTION("creating when missing") {
+        auto missing = temporary_path();
+        auto persistent = ben::persistent_box<long>::open_or_create(missing.path, 4096, 1, 7);
+
+        REQUIRE(*persistent == 7);
+        REQUIRE_THROWS(ben::persistent_box<long>::open(missing.path + ".missing", 1));
+    }
+}
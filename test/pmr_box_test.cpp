@@ -0,0 +1,97 @@
+#include "box.hpp"
+#include <catch2/catch.hpp>
+
+#include <cstddef>
+#include <memory_resource>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace {
+    struct buffer {
+        alignas(std::max_align_t) std::byte data[1024];
+
+        auto contains(void const* ptr) const -> bool {
+            auto address = static_cast<std::byte const*>(ptr);
+            return data <= address && address < data + sizeof(data);
+        }
+    };
+}
+
+TEST_CASE("pmr::box") {
+    static_assert(std::is_same_v<ben::pmr::box<int>, ben::box<int, std::pmr::polymorphic_allocator<int>>>);
+    static_assert(std::is_nothrow_move_constructible_v<ben::pmr::box<int>>);
+
+    auto storage = buffer();
+    auto resource = std::pmr::monotonic_buffer_resource(storage.data, sizeof(storage.data),
+                                                        std::pmr::null_memory_resource());
+
+    SECTION("Allocates from its resource") {
+        auto box = ben::pmr::box<int>(5, &resource);
+
+        REQUIRE(box.value() == 5);
+        REQUIRE(storage.contains(&box.value()));
+        REQUIRE(box.get_allocator().resource() == &resource);
+    }
+
+    SECTION("Passes its resource on to the element") {
+        auto box = ben::pmr::box<std::pmr::string>(&resource);
+        box.emplace("A string that is long enough to need memory of its own.");
+
+        REQUIRE(box.value().get_allocator().resource() == &resource);
+        REQUIRE(storage.contains(box.value().data()));
+    }
+
+    SECTION("Copies use the default resource") {
+        auto box = ben::pmr::box<int>(5, &resource);
+        auto cpy = box;
+
+        REQUIRE(cpy.value() == 5);
+        REQUIRE(cpy.get_allocator().resource() == std::pmr::get_default_resource());
+        REQUIRE(!storage.contains(&cpy.value()));
+    }
+
+    SECTION("Copy assignment keeps the resource") {
+        auto box = ben::pmr::box<int>(5);
+        auto other = ben::pmr::box<int>(&resource);
+
+        other = box;
+
+        REQUIRE(other.value() == 5);
+        REQUIRE(other.get_allocator().resource() == &resource);
+        REQUIRE(storage.contains(&other.value()));
+    }
+
+    SECTION("Move assignment with the same resource steals the pointer") {
+        auto box = ben::pmr::box<int>(5, &resource);
+        auto other = ben::pmr::box<int>(&resource);
+        auto address = &box.value();
+
+        other = std::move(box);
+
+        REQUIRE(&other.value() == address);
+        REQUIRE(!box.has_value());
+    }
+
+    SECTION("Move assignment with another resource moves the element") {
+        auto pool = std::pmr::unsynchronized_pool_resource();
+        auto box = ben::pmr::box<std::pmr::string>(std::pmr::string(64, 'a', &pool), &pool);
+        auto other = ben::pmr::box<std::pmr::string>(&resource);
+
+        other = std::move(box);
+
+        REQUIRE(other.value() == std::pmr::string(64, 'a'));
+        REQUIRE(other.get_allocator().resource() == &resource);
+        REQUIRE(storage.contains(&other.value()));
+        REQUIRE(storage.contains(other.value().data()));
+    }
+
+    SECTION("Move construction keeps the resource") {
+        auto box = ben::pmr::box<int>(5, &resource);
+        auto address = &box.value();
+        auto moved = std::move(box);
+
+        REQUIRE(&moved.value() == address);
+        REQUIRE(moved.get_allocator().resource() == &resource);
+    }
+}
@@ -0,0 +1,242 @@
+#include "polymorphic_box.hpp"
+#include <catch2/catch.hpp>
+
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace {
+    struct shape {
+        virtual ~shape() = default;
+        virtual auto name() const -> std::string = 0;
+    };
+
+    struct circle : shape {
+        int radius = 0;
+
+        explicit circle(int radius) : radius(radius) {}
+
+        auto name() const -> std::string override {
+            return "circle";
+        }
+    };
+
+    struct labelled_square : shape {
+        std::string label;
+        int side = 0;
+
+        labelled_square(std::string label, int side) : label(std::move(label)), side(side) {}
+
+        auto name() const -> std::string override {
+            return "square " + label;
+        }
+    };
+
+    struct big_shape : shape {
+        char payload[256] = {};
+
+        auto name() const -> std::string override {
+            return "big";
+        }
+    };
+
+    template <typename Box>
+    auto stored_inline(Box const& box) -> bool {
+        auto address = reinterpret_cast<char const*>(&box.value());
+        auto begin = reinterpret_cast<char const*>(&box);
+
+        return begin <= address && address < begin + sizeof(box);
+    }
+
+    // Deliberately has no virtual destructor.
+    struct plain_base {
+        int id = 0;
+    };
+
+    struct tracked : plain_base {
+        static inline int alive = 0;
+
+        tracked() {
+            ++alive;
+        }
+
+        tracked(tracked const& other) noexcept : plain_base(other) {
+            ++alive;
+        }
+
+        ~tracked() {
+            --alive;
+        }
+    };
+}
+
+TEST_CASE("polymorphic_box construction") {
+    SECTION("Default construction") {
+        auto box = ben::polymorphic_box<shape>();
+
+        REQUIRE(!box.has_value());
+        REQUIRE(box.size() == 0);
+        REQUIRE(box.begin() == box.end());
+    }
+
+    SECTION("From a derived object") {
+        auto box = ben::polymorphic_box<shape>(circle(3));
+
+        REQUIRE(box.has_value());
+        REQUIRE(box.size() == 1);
+        REQUIRE(box->name() == "circle");
+        REQUIRE(static_cast<circle const&>(*box).radius == 3);
+    }
+
+    SECTION("In place") {
+        auto box = ben::polymorphic_box<shape>(std::in_place_type<labelled_square>, "a", 2);
+
+        REQUIRE(box.value().name() == "square a");
+    }
+}
+
+TEST_CASE("polymorphic_box copies the dynamic type") {
+    auto box = ben::polymorphic_box<shape>(labelled_square("b", 4));
+    auto cpy = box;
+
+    REQUIRE(cpy->name() == "square b");
+    REQUIRE(&cpy.value() != &box.value());
+    REQUIRE(static_cast<labelled_square const&>(*cpy).side == 4);
+
+    auto other = ben::polymorphic_box<shape>(circle(1));
+    other = box;
+
+    REQUIRE(other->name() == "square b");
+
+    auto shapes = std::vector<ben::polymorphic_box<shape>>();
+    shapes.emplace_back(circle(1));
+    shapes.emplace_back(labelled_square("c", 1));
+
+    auto copies = shapes;
+
+    REQUIRE(copies[0]->name() == "circle");
+    REQUIRE(copies[1]->name() == "square c");
+}
+
+TEST_CASE("polymorphic_box move and modifiers") {
+    auto box = ben::polymorphic_box<shape>(circle(3));
+    auto address = &box.value();
+    auto moved = std::move(box);
+
+    REQUIRE(!box.has_value());
+    REQUIRE(&moved.value() == address);
+
+    box = std::move(moved);
+    REQUIRE(&box.value() == address);
+
+    box.emplace<labelled_square>("d", 5);
+    REQUIRE(box->name() == "square d");
+
+    box.push(circle(2));
+    REQUIRE(box->name() == "circle");
+
+    box.erase();
+    REQUIRE(!box.has_value());
+    REQUIRE(!box.safe_value().has_value());
+
+    static_assert(std::is_nothrow_move_constructible_v<ben::polymorphic_box<shape>>);
+    static_assert(std::is_nothrow_move_assignable_v<ben::polymorphic_box<shape>>);
+}
+
+TEST_CASE("polymorphic_box destroys the dynamic type") {
+    {
+        auto box = ben::polymorphic_box<plain_base>(tracked());
+        auto cpy = box;
+
+        REQUIRE(tracked::alive == 2);
+    }
+
+    REQUIRE(tracked::alive == 0);
+}
+
+TEST_CASE("polymorphic_box with inline storage") {
+    using small_box = ben::polymorphic_box<shape, 64>;
+
+    static_assert(sizeof(ben::polymorphic_box<shape>) == 2 * sizeof(void*));
+    static_assert(sizeof(small_box) >= 64 + 2 * sizeof(void*));
+    static_assert(std::is_nothrow_move_constructible_v<small_box>);
+
+    SECTION("Small types are stored inline, large ones on the heap") {
+        auto small = small_box(labelled_square("e", 1));
+        auto large = small_box(big_shape());
+
+        REQUIRE(stored_inline(small));
+        REQUIRE(!stored_inline(large));
+        REQUIRE(small->name() == "square e");
+        REQUIRE(large->name() == "big");
+    }
+
+    SECTION("Copy and move") {
+        auto box = small_box(labelled_square("f", 2));
+        auto cpy = box;
+
+        REQUIRE(stored_inline(cpy));
+        REQUIRE(cpy->name() == "square f");
+
+        auto moved = std::move(box);
+
+        REQUIRE(!box.has_value());
+        REQUIRE(stored_inline(moved));
+        REQUIRE(moved->name() == "square f");
+
+        box = small_box(big_shape());
+        moved = box;
+        REQUIRE(moved->name() == "big");
+
+        moved = small_box(circle(1));
+        REQUIRE(stored_inline(moved));
+        REQUIRE(moved->name() == "circle");
+    }
+
+    SECTION("swap between inline and heap elements") {
+        auto a = small_box(circle(3));
+        auto b = small_box(big_shape());
+
+        swap(a, b);
+
+        REQUIRE(a->name() == "big");
+        REQUIRE(b->name() == "circle");
+        REQUIRE(stored_inline(b));
+
+        auto empty = small_box();
+        swap(b, empty);
+
+        REQUIRE(!b.has_value());
+        REQUIRE(empty->name() == "circle");
+    }
+
+    SECTION("Modifiers") {
+        auto box = small_box();
+
+        box.emplace<circle>(4);
+        REQUIRE(stored_inline(box));
+
+        box.emplace<big_shape>();
+        REQUIRE(!stored_inline(box));
+
+        box.push(labelled_square("g", 1));
+        REQUIRE(box->name() == "square g");
+
+        box.erase();
+        REQUIRE(!box.has_value());
+    }
+
+    SECTION("Lifetimes") {
+        {
+            auto box = ben::polymorphic_box<plain_base, 16>(tracked());
+            auto cpy = box;
+            auto moved = std::move(box);
+
+            REQUIRE(stored_inline(moved));
+            REQUIRE(tracked::alive == 2);
+        }
+
+        REQUIRE(tracked::alive == 0);
+    }
+}
@@ -0,0 +1,129 @@
+#include "box.hpp"
+#include "pool_allocator.hpp"
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+    template <typename T>
+    using pool_box = ben::box<T, ben::pool_allocator<T>>;
+
+    // Pools are shared by all types with the same block size, so every test uses an element type of its own size
+    // to get fresh pools.
+    template <int Tag>
+    struct tagged {
+        long value = 0;
+        char padding[512 + Tag * 16] = {};
+    };
+}
+
+TEST_CASE("pool_allocator with box") {
+    static_assert(sizeof(pool_box<int>) == sizeof(int*));
+
+    auto box = pool_box<std::string>(std::string("pooled"));
+    auto cpy = box;
+
+    REQUIRE(cpy.value() == "pooled");
+
+    cpy = std::move(box);
+    REQUIRE(cpy.value() == "pooled");
+    REQUIRE(!box.has_value());
+
+    auto boxes = std::vector<pool_box<int>>();
+    for (int i = 0; i < 10000; ++i) {
+        boxes.emplace_back(i);
+    }
+
+    for (int i = 0; i < 10000; ++i) {
+        REQUIRE(boxes[i].value() == i);
+    }
+}
+
+TEST_CASE("pool_allocator reuses blocks") {
+    auto alloc = ben::pool_allocator<tagged<0>>();
+
+    auto first = alloc.allocate(1);
+    alloc.deallocate(first, 1);
+
+    auto second = alloc.allocate(1);
+    REQUIRE(second == first);
+    alloc.deallocate(second, 1);
+
+    auto array = alloc.allocate(3);
+    alloc.deallocate(array, 3);
+
+    auto large = ben::pool_allocator<std::array<char, 1 << 16>>();
+    large.deallocate(large.allocate(1), 1);
+}
+
+TEST_CASE("pool_allocator frees across threads") {
+    SECTION("Blocks freed by another thread are reused by their owner") {
+        auto alloc = ben::pool_allocator<tagged<1>>();
+        auto blocks = std::vector<tagged<1>*>();
+
+        for (int i = 0; i < 100; ++i) {
+            blocks.push_back(alloc.allocate(1));
+        }
+
+        std::thread([&] {
+            for (auto block : blocks) {
+                alloc.deallocate(block, 1);
+            }
+        }).join();
+
+        // All blocks carved so far are now on the remote free list and are handed out again before any new ones.
+        for (int i = 0; i < 100; ++i) {
+            auto block = alloc.allocate(1);
+            REQUIRE(std::find(blocks.begin(), blocks.end(), block) != blocks.end());
+        }
+    }
+
+    SECTION("Boxes can be destroyed on any thread") {
+        auto boxes = std::vector<pool_box<tagged<2>>>();
+
+        std::thread([&] {
+            for (int i = 0; i < 1000; ++i) {
+                boxes.emplace_back(tagged<2>{i});
+            }
+        }).join();
+
+        // Catch's assertions are not thread-safe, so mismatches are only counted on the worker threads.
+        auto mismatches = std::atomic<int>(0);
+        auto threads = std::vector<std::thread>();
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&, t] {
+                for (auto i = std::size_t(t); i < boxes.size(); i += 4) {
+                    if (boxes[i].value().value != static_cast<long>(i)) {
+                        ++mismatches;
+                    }
+
+                    boxes[i] = pool_box<tagged<2>>();
+                }
+            });
+        }
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        REQUIRE(mismatches == 0);
+    }
+
+    SECTION("Pools of exited threads are adopted") {
+        auto alloc = ben::pool_allocator<tagged<3>>();
+        tagged<3>* block = nullptr;
+
+        std::thread([&] {
+            block = alloc.allocate(1);
+            alloc.deallocate(block, 1);
+        }).join();
+
+        REQUIRE(alloc.allocate(1) == block);
+    }
+}
@@ -0,0 +1,179 @@
+#include "relocate.hpp"
+#include "sbo_box.hpp"
+#include <catch2/catch.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace {
+    // Remembers the address it was created at, so it must never be relocated by copying bytes.
+    struct self_referential {
+        self_referential* self = this;
+        int value = 0;
+
+        self_referential(int value) : value(value) {}
+        self_referential(self_referential const& other) : value(other.value) {}
+        self_referential(self_referential&& other) noexcept : value(other.value) {}
+    };
+
+    template <typename T>
+    struct address_sensitive_allocator : std::allocator<T> {
+        template <typename U>
+        struct rebind {
+            using other = address_sensitive_allocator<U>;
+        };
+
+        address_sensitive_allocator() = default;
+        address_sensitive_allocator(address_sensitive_allocator const&) {}
+    };
+
+    // May throw when copied, and is not nothrow movable, so growing has to copy it.
+    struct throws_on_copy {
+        static inline int copies_until_throw = -1;
+
+        int value = 0;
+
+        throws_on_copy(int value) : value(value) {}
+
+        throws_on_copy(throws_on_copy const& other) : value(other.value) {
+            if (copies_until_throw-- == 0) {
+                throw std::runtime_error("copy");
+            }
+        }
+
+        throws_on_copy(throws_on_copy&& other) : value(other.value) {
+            other.value = -1;
+        }
+    };
+
+    template <typename T>
+    struct buffer {
+        std::allocator<T> alloc;
+        T* data;
+        std::size_t capacity;
+
+        explicit buffer(std::size_t capacity) : data(alloc.allocate(capacity)), capacity(capacity) {}
+
+        ~buffer() {
+            alloc.deallocate(data, capacity);
+        }
+    };
+}
+
+TEST_CASE("is_trivially_relocatable") {
+    static_assert(ben::is_trivially_relocatable_v<int>);
+    static_assert(!ben::is_trivially_relocatable_v<self_referential>);
+
+    static_assert(ben::is_trivially_relocatable_v<ben::box<int>>);
+    static_assert(ben::is_trivially_relocatable_v<ben::box<std::string>>);
+    static_assert(ben::is_trivially_relocatable_v<ben::box<self_referential>>);
+    static_assert(!ben::is_trivially_relocatable_v<ben::box<int, address_sensitive_allocator<int>>>);
+    static_assert(ben::is_trivially_relocatable_v<ben::pmr::box<int>>);
+
+    // Inline elements move along with the box.
+    static_assert(ben::is_trivially_relocatable_v<ben::inline_box<int>>);
+    static_assert(!ben::is_trivially_relocatable_v<ben::inline_box<self_referential>>);
+}
+
+TEST_CASE("uninitialized_relocate") {
+    SECTION("Trivially relocatable elements") {
+        auto from = buffer<ben::box<std::string>>(3);
+        auto to = buffer<ben::box<std::string>>(3);
+
+        new (from.data) ben::box<std::string>("foo");
+        new (from.data + 1) ben::box<std::string>();
+        new (from.data + 2) ben::box<std::string>("bar");
+
+        auto address = &from.data[0].value();
+        auto end = ben::uninitialized_relocate(from.data, from.data + 3, to.data);
+
+        REQUIRE(end == to.data + 3);
+        REQUIRE(to.data[0].value() == "foo");
+        REQUIRE(!to.data[1].has_value());
+        REQUIRE(to.data[2].value() == "bar");
+
+        // Only the boxes were moved, not their elements.
+        REQUIRE(&to.data[0].value() == address);
+
+        std::destroy(to.data, to.data + 3);
+    }
+
+    SECTION("Other elements are moved and destroyed") {
+        auto from = buffer<self_referential>(2);
+        auto to = buffer<self_referential>(2);
+
+        new (from.data) self_referential(1);
+        new (from.data + 1) self_referential(2);
+
+        ben::uninitialized_relocate(from.data, from.data + 2, to.data);
+
+        REQUIRE(to.data[0].value == 1);
+        REQUIRE(to.data[0].self == &to.data[0]);
+        REQUIRE(to.data[1].value == 2);
+        REQUIRE(to.data[1].self == &to.data[1]);
+
+        std::destroy(to.data, to.data + 2);
+    }
+
+    SECTION("Empty ranges") {
+        auto to = buffer<ben::box<int>>(1);
+        REQUIRE(ben::uninitialized_relocate(to.data, to.data, to.data) == to.data);
+    }
+}
+
+TEST_CASE("relocate_grow") {
+    SECTION("Boxes") {
+        auto alloc = std::allocator<ben::box<int>>();
+        auto data = alloc.allocate(2);
+
+        new (data) ben::box<int>(1);
+        new (data + 1) ben::box<int>(2);
+
+        data = ben::relocate_grow(alloc, data, 2, 2, 4);
+        new (data + 2) ben::box<int>(3);
+
+        REQUIRE(data[0].value() == 1);
+        REQUIRE(data[1].value() == 2);
+        REQUIRE(data[2].value() == 3);
+
+        std::destroy(data, data + 3);
+        alloc.deallocate(data, 4);
+    }
+
+    SECTION("Growing from nothing") {
+        auto alloc = std::allocator<ben::box<int>>();
+        auto data = ben::relocate_grow(alloc, static_cast<ben::box<int>*>(nullptr), 0, 0, 1);
+
+        REQUIRE(data != nullptr);
+        alloc.deallocate(data, 1);
+    }
+
+    SECTION("Elements that may throw when moved are copied") {
+        auto alloc = std::allocator<throws_on_copy>();
+        auto data = alloc.allocate(2);
+
+        new (data) throws_on_copy(1);
+        new (data + 1) throws_on_copy(2);
+
+        throws_on_copy::copies_until_throw = 1;
+        REQUIRE_THROWS(ben::relocate_grow(alloc, data, 2, 2, 4));
+
+        // The old elements are untouched.
+        REQUIRE(data[0].value == 1);
+        REQUIRE(data[1].value == 2);
+
+        throws_on_copy::copies_until_throw = -1;
+        data = ben::relocate_grow(alloc, data, 2, 2, 4);
+
+        REQUIRE(data[0].value == 1);
+        REQUIRE(data[1].value == 2);
+
+        std::destroy(data, data + 2);
+        alloc.deallocate(data, 4);
+    }
+}
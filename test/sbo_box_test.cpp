@@ -0,0 +1,157 @@
+#include "sbo_box.hpp"
+#include <catch2/catch.hpp>
+
+#include <array>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace {
+    struct throwing_move {
+        int value = 0;
+
+        throwing_move(int value) : value(value) {}
+        throwing_move(throwing_move const&) = default;
+        throwing_move(throwing_move&& other) : value(other.value) {}
+        auto operator=(throwing_move const&) -> throwing_move& = default;
+    };
+
+    struct not_assignable {
+        int const value = 0;
+
+        not_assignable(int value) : value(value) {}
+    };
+
+    using big = std::array<char, 256>;
+}
+
+TEST_CASE("sbo_box storage selection") {
+    static_assert(std::is_same_v<ben::sbo_box<int>, ben::inline_box<int>>);
+    static_assert(std::is_same_v<ben::sbo_box<std::string>, ben::inline_box<std::string>>);
+    static_assert(std::is_same_v<ben::sbo_box<big>, ben::box<big>>);
+    static_assert(std::is_same_v<ben::sbo_box<big, sizeof(big)>, ben::inline_box<big>>);
+    static_assert(std::is_same_v<ben::sbo_box<throwing_move>, ben::box<throwing_move>>);
+
+    static_assert(sizeof(ben::sbo_box<int>) <= 2 * sizeof(int));
+    static_assert(std::is_nothrow_move_constructible_v<ben::sbo_box<std::string>>);
+}
+
+TEST_CASE("sbo_box interface") {
+    auto literal = std::string("A string long enough to not fit into the small string buffer.");
+
+    SECTION("Construction") {
+        auto empty = ben::sbo_box<std::string>();
+
+        REQUIRE(!empty.has_value());
+        REQUIRE(empty.size() == 0);
+        REQUIRE(empty.begin() == empty.end());
+
+        auto box = ben::sbo_box<std::string>(literal);
+
+        REQUIRE(box.has_value());
+        REQUIRE(box.size() == 1);
+        REQUIRE(box.value() == literal);
+        REQUIRE(box.begin() + 1 == box.end());
+
+        // The element lives inside the box itself.
+        auto const* address = reinterpret_cast<char const*>(&box.value());
+        REQUIRE(address >= reinterpret_cast<char const*>(&box));
+        REQUIRE(address < reinterpret_cast<char const*>(&box) + sizeof(box));
+    }
+
+    SECTION("Copy and move") {
+        auto box = ben::sbo_box<std::string>(literal);
+        auto cpy = box;
+
+        REQUIRE(cpy.value() == literal);
+        REQUIRE(box.value() == literal);
+
+        auto moved = std::move(box);
+
+        REQUIRE(moved.value() == literal);
+        REQUIRE(!box.has_value());
+
+        box = moved;
+        REQUIRE(box.value() == literal);
+
+        cpy = ben::sbo_box<std::string>();
+        REQUIRE(!cpy.has_value());
+
+        cpy = std::move(moved);
+        REQUIRE(cpy.value() == literal);
+        REQUIRE(!moved.has_value());
+    }
+
+    SECTION("Modifiers") {
+        auto box = ben::sbo_box<std::string>();
+
+        box.emplace(3, 'a');
+        REQUIRE(box.value() == "aaa");
+
+        box.push(literal);
+        REQUIRE(box.value() == literal);
+
+        box.erase();
+        REQUIRE(!box.has_value());
+        REQUIRE(!box.safe_value().has_value());
+
+        box.push(std::string("b"));
+        REQUIRE(*box == "b");
+    }
+
+    SECTION("Elements that are not assignable") {
+        static_assert(std::is_same_v<ben::sbo_box<not_assignable>, ben::inline_box<not_assignable>>);
+
+        auto box = ben::sbo_box<not_assignable>(1);
+        box.emplace(2);
+
+        REQUIRE(box.value().value == 2);
+
+        // Arguments that refer to the element are still safe for types that can be assigned.
+        using optional_string = std::optional<std::string>;
+        auto strings = ben::sbo_box<optional_string, sizeof(optional_string)>(literal);
+        strings.emplace(std::move(*strings.value()));
+
+        REQUIRE(strings.value() == literal);
+    }
+
+    SECTION("swap") {
+        auto a = ben::sbo_box<std::string>(literal);
+        auto b = ben::sbo_box<std::string>();
+
+        swap(a, b);
+
+        REQUIRE(!a.has_value());
+        REQUIRE(b.value() == literal);
+
+        a.push("a");
+        swap(a, b);
+
+        REQUIRE(a.value() == literal);
+        REQUIRE(b.value() == "a");
+    }
+
+    SECTION("Heap fallback") {
+        auto box = ben::sbo_box<throwing_move>(throwing_move(5));
+        auto cpy = box;
+
+        REQUIRE(cpy.value().value == 5);
+    }
+}
+
+TEST_CASE("inline_box storage") {
+    auto box = ben::inline_box<int>(1);
+
+    REQUIRE(box.capacity() == 1);
+
+    box.reset();
+    REQUIRE(!box.has_value());
+    REQUIRE(box.capacity() == 1);
+
+    box.reserve();
+    box.shrink_to_fit();
+    box.push(2);
+
+    REQUIRE(box.value() == 2);
+}
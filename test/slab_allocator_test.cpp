@@ -0,0 +1,83 @@
+#include "slab_allocator.hpp"
+#include <catch2/catch.hpp>
+
+#include <string>
+#include <utility>
+
+namespace {
+    struct point {
+        long x;
+        long y;
+    };
+}
+
+TEST_CASE("make_boxes") {
+    auto boxes = ben::make_boxes<point>(100, point{1, 2});
+
+    REQUIRE(boxes.size() == 100);
+
+    for (auto i = std::size_t(1); i < boxes.size(); ++i) {
+        REQUIRE(&boxes[i].value() == &boxes[i - 1].value() + 1);
+    }
+
+    SECTION("boxes keep their own values") {
+        boxes[3].value().x = 10;
+        boxes[4].emplace(point{5, 6});
+
+        REQUIRE(boxes[2].value().x == 1);
+        REQUIRE(boxes[3].value().x == 10);
+        REQUIRE(boxes[4].value().y == 6);
+        REQUIRE(boxes[0].get_allocator().remaining() == 0);
+    }
+
+    SECTION("copies are allocated separately") {
+        auto copy = boxes[0];
+        copy.value().x = 7;
+
+        REQUIRE(boxes[0].value().x == 1);
+        REQUIRE((&copy.value() < &boxes.front().value() || &copy.value() > &boxes.back().value()));
+
+        boxes[1] = copy;
+        REQUIRE(boxes[1].value().x == 7);
+    }
+
+    SECTION("the slab outlives the collection while boxes remain") {
+        auto kept = std::move(boxes[50]);
+        boxes.clear();
+
+        REQUIRE(kept.value().y == 2);
+    }
+
+    SECTION("erasing and destroying") {
+        boxes[0].erase();
+        boxes[1].reset();
+        boxes.resize(10);
+
+        REQUIRE(!boxes[0].has_value());
+        REQUIRE(boxes[9].value().x == 1);
+    }
+}
+
+TEST_CASE("slab_allocator") {
+    auto alloc = ben::slab_allocator<std::string>(2);
+
+    REQUIRE(alloc.remaining() == 2);
+
+    auto a = ben::box<std::string, ben::slab_allocator<std::string>>(std::string("a"), alloc);
+    auto b = ben::box<std::string, ben::slab_allocator<std::string>>(std::string("b"), alloc);
+    auto c = ben::box<std::string, ben::slab_allocator<std::string>>(std::string("c"), alloc);
+
+    REQUIRE(alloc.remaining() == 0);
+    REQUIRE(&b.value() == &a.value() + 1);
+    REQUIRE(c.value() == "c");
+
+    REQUIRE(alloc == a.get_allocator());
+    REQUIRE(alloc != ben::slab_allocator<std::string>());
+    REQUIRE(ben::slab_allocator<long>(alloc) == alloc);
+
+    auto array = alloc.allocate(3);
+    alloc.deallocate(array, 3);
+
+    static_assert(ben::is_trivially_relocatable_v<ben::box<long, ben::slab_allocator<long>>>);
+    REQUIRE(ben::make_boxes<long>(0).empty());
+}